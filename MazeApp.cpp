@@ -15,266 +15,905 @@
  *
  * ------------------------------------------------------------------------- */
 
+#include <chrono>
 #include <iostream>
 #include <fstream>
 #include <sstream>
+#include <vector>
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #include "MazeApp.h"
+#include "MazeBatch.h"
+#include "MazeBinary.h"
+#include "MazeCache.h"
+#include "MazeField.h"
+#include "MazeGraph.h"
+#include "MazeJump.h"
+#include "MazeScan.h"
+#include "MazeSearch.h"
+#include "MazeServer.h"
+#include "MazeStats.h"
+#include "MazeStream.h"
 
 using namespace std;
 
 
 //-----------------------------------------------------------------------------
-// Globals
+// Main function
 //-----------------------------------------------------------------------------
 
-/** This indicates very obvious errors, as it states... **/
-const int FLAGRANT_ERROR = -1;
+// The benchmark (MazeBench.cpp) is built with MAZEAPP_LIBRARY defined, to
+// use the functions below with a main() of its own
+#ifndef MAZEAPP_LIBRARY
 
-/** These indicate directions, as they state! **/
-const char EAST = 'E';
-const char NORTH = 'N';
-const char WEST = 'W';
-const char SOUTH = 'S';
+int main(int argc, char *argv[])
+{
+  /** READ IN COMMAND LINE ARGUMENTS **/
 
+  /** How to search (engine and heuristic) **/
+  MazeSearchOptions options;
+  options.engine = ENGINE_DFS;
+  options.heuristic = manhattanHeuristic;
+  options.heuristicName = "manhattan";
+  options.threadCount = 0;
+  options.maxMemory = 0;
+  options.precheck = true;
+  options.collectStats = false;
+  options.cache = NULL;
+
+  /** Solve many mazes in one run? **/
+  bool batchMode = false;
+  int threadCount = 0; // one per core
+
+  /** Answer queries off the distance field instead of solving? **/
+  bool buildField = false;
+  vector<Position> queries;
+
+  /** Convert the maze to another format instead of solving? **/
+  string convertFileName = "";
+  bool convertToBinary = false;
+
+  /** Solve a band of rows at a time (0 rows per band: pick), spending up
+      to maxSweeps sweeps on the path length? **/
+  bool streamMode = false;
+  long long bandRows = 0;
+  int maxSweeps = 0;
+
+  /** Remember solutions, in memory (up to cacheSize bytes) and maybe in
+      a directory? **/
+  bool useCache = false;
+  long long cacheSize = MAZE_CACHE_DEFAULT_SIZE;
+  string cacheDirectory = "";
+
+  /** Answer requests on a socket instead of solving a file? **/
+  string socketPath = "";
+
+  /** The maze input file names **/
+  vector<string> inputFileNames;
+  bool validArgs = true;
+
+  for(int i = 1; i < argc; i++)
+    {
+      string arg = argv[i];
+
+      if(arg == "--bfs")
+	options.engine = ENGINE_BFS;
+      else if(arg == "--astar")
+	options.engine = ENGINE_ASTAR;
+      else if(arg == "--parallel-bfs")
+	options.engine = ENGINE_PARALLEL_BFS;
+      else if(arg == "--bidirectional")
+	options.engine = ENGINE_BIDIRECTIONAL;
+      else if(arg == "--junctions")
+	options.engine = ENGINE_JUNCTIONS;
+      else if(arg == "--multi")
+	options.engine = ENGINE_MULTI_SOURCE;
+      else if(arg == "--idastar")
+	options.engine = ENGINE_IDASTAR;
+      else if(arg == "--jps")
+	options.engine = ENGINE_JUMP_POINTS;
+      else if(arg.compare(0, 13, "--max-memory=") == 0)
+	{
+	  if( !(readByteCount(arg.substr(13), options.maxMemory)) ||
+	      (options.maxMemory < 1) )
+	    validArgs = false;
+	}
+      else if(arg.compare(0, 8, "--cache=") == 0)
+	{
+	  if( !(readByteCount(arg.substr(8), cacheSize)) )
+	    validArgs = false;
+	  useCache = true;
+	}
+      else if(arg.compare(0, 12, "--cache-dir=") == 0)
+	{
+	  cacheDirectory = arg.substr(12);
+	  if(cacheDirectory.length() == 0)
+	    validArgs = false;
+	  useCache = true;
+	}
+      else if(arg.compare(0, 12, "--heuristic=") == 0)
+	{
+	  options.heuristicName = arg.substr(12);
+	  options.heuristic = findHeuristic(options.heuristicName);
+	  if(options.heuristic == NULL)
+	    validArgs = false;
+	}
+      else if(arg == "--no-precheck")
+	options.precheck = false;
+      else if(arg == "--stats")
+	options.collectStats = true;
+      else if(arg == "--batch")
+	batchMode = true;
+      else if(arg == "--field")
+	buildField = true;
+      else if(arg == "--stream")
+	streamMode = true;
+      else if(arg.compare(0, 12, "--band-rows=") == 0)
+	{
+	  bandRows = atoll(arg.substr(12).c_str());
+	  if(bandRows < 1)
+	    validArgs = false;
+	}
+      else if(arg.compare(0, 9, "--sweeps=") == 0)
+	{
+	  maxSweeps = atoi(arg.substr(9).c_str());
+	  if(maxSweeps < 1)
+	    validArgs = false;
+	}
+      else if(arg.compare(0, 12, "--to-binary=") == 0)
+	{
+	  convertFileName = arg.substr(12);
+	  convertToBinary = true;
+	}
+      else if(arg.compare(0, 10, "--to-text=") == 0)
+	{
+	  convertFileName = arg.substr(10);
+	  convertToBinary = false;
+	}
+      else if(arg.compare(0, 8, "--serve=") == 0)
+	{
+	  socketPath = arg.substr(8);
+	  if(socketPath.length() == 0)
+	    validArgs = false;
+	}
+      else if(arg.compare(0, 8, "--query=") == 0)
+	{
+	  Position query;
+	  if(sscanf(arg.c_str() + 8, "%d,%d", &query.x, &query.y) == 2)
+	    queries.push_back(query);
+	  else
+	    validArgs = false;
+	}
+      else if(arg.compare(0, 10, "--threads=") == 0)
+	{
+	  threadCount = atoi(arg.substr(10).c_str());
+	  options.threadCount = threadCount;
+	}
+      else
+	inputFileNames.push_back(arg);
+    }
 
-//-----------------------------------------------------------------------------
-// Main function
-//-----------------------------------------------------------------------------
+  if( batchMode && validArgs )
+    {
+      // Expand directories and @manifests into the files they name
+      vector<string> batchFileNames;
+      for(unsigned int i = 0; i < inputFileNames.size(); i++)
+	{
+	  if( !(collectBatchFiles(inputFileNames[i], batchFileNames)) )
+	    {
+	      cerr << "Cannot read \"" << inputFileNames[i] << "\"." << endl;
+	      exit(0);
+	    }
+	}
+      inputFileNames = batchFileNames;
 
-int main(int argc, char *argv[])
-{
-  if(argc != 2)
+      // The threads go to solving mazes side by side, not to one search
+      options.threadCount = 1;
+    }
+
+  bool fieldMode = buildField || (queries.size() > 0);
+  bool convertMode = (convertFileName.length() > 0);
+  bool serveMode = (socketPath.length() > 0);
+
+  if( !validArgs || (serveMode != (inputFileNames.size() == 0)) ||
+      (!batchMode && !serveMode && (inputFileNames.size() != 1)) ||
+      ((batchMode + fieldMode + convertMode + streamMode + serveMode) > 1) ||
+      (((bandRows > 0) || (maxSweeps > 0)) && !streamMode) ||
+      ((options.maxMemory > 0) && (options.engine != ENGINE_IDASTAR)) ||
+      ((options.collectStats || useCache) &&
+       (fieldMode || convertMode || streamMode || serveMode)) )
     {
       cerr << "Invalid argument form." << endl;
-      cerr << "Use form: 'MazeApp inputFile'" << endl;
+      cerr << "Use form: 'MazeApp [--bfs | --bidirectional | --junctions | "
+	   << "--multi |" << endl
+	   << "                   --astar [--heuristic=name] |" << endl
+	   << "                   --idastar [--heuristic=name] "
+	   << "[--max-memory=bytes] |" << endl
+	   << "                   --jps [--heuristic=name] |" << endl
+	   << "                   --parallel-bfs [--threads=n]] [--stats]"
+	   << endl
+	   << "                  [--cache=bytes] [--cache-dir=directory] "
+	   << "inputFile'" << endl;
+      cerr << "      or: 'MazeApp [search options] [--stats] [cache options] "
+	   << "--batch" << endl
+	   << "                   [--threads=n] inputFile|directory|@manifest "
+	   << "...'" << endl;
+      cerr << "      or: 'MazeApp [--field] [--query=row,col ...] "
+	   << "inputFile'" << endl;
+      cerr << "      or: 'MazeApp --to-binary=outputFile | "
+	   << "--to-text=outputFile inputFile'" << endl;
+      cerr << "      or: 'MazeApp --stream [--band-rows=n] [--sweeps=n] "
+	   << "inputFile'" << endl;
+      cerr << "      or: 'MazeApp --serve=socketPath'" << endl;
       exit(0);
     }
 
-  /** READ IN COMMAND LINE ARGUMENTS **/
-  
-  /** The maze input file name **/
-  string inputFileName = argv[1];
-  
+  /** Solutions remembered between mazes (and runs, with a directory) **/
+  MazeCache cache;
+  if(useCache)
+    {
+      initMazeCache(cache, cacheSize, cacheDirectory);
+      options.cache = &cache;
+    }
+
+  /** DISPLAY WELCOME AND SOLVE **/
+  cout << "Welcome to Merlin's wizardry, your highness!" << endl;
+
+  if(batchMode)
+    {
+      runMazeBatch(inputFileNames, options, threadCount, cout);
+    }
+  else if(serveMode)
+    {
+      if(runMazeServer(socketPath, cout, cerr) == FLAGRANT_ERROR)
+	exit(0);
+    }
+  else if(streamMode)
+    {
+      if(streamMazeFile(inputFileNames[0], bandRows, maxSweeps, cout,
+			 cerr) == FLAGRANT_ERROR)
+	exit(0);
+    }
+  else if(convertMode)
+    {
+      if(convertMazeFile(inputFileNames[0], convertFileName, convertToBinary,
+			 cout, cerr) == FLAGRANT_ERROR)
+	exit(0);
+    }
+  else if(fieldMode)
+    {
+      if(answerMazeQueries(inputFileNames[0], queries, buildField, cout,
+			   cerr) == FLAGRANT_ERROR)
+	exit(0);
+    }
+  else
+    {
+      if(solveMazeFile(inputFileNames[0], options, cout, cerr) ==
+	 FLAGRANT_ERROR)
+	exit(0);
+    }
+
+  cout << "Thank you for using merlin's MazeApp." << endl;
+
+  return 0;
+}
+
+#endif
+
+
+//-----------------------------------------------------------------------------
+// Program functions
+//-----------------------------------------------------------------------------
+
+/*
+ * Purpose : Reads, solves and displays one maze (everything main() does for
+ *         : a single maze, between the welcome and the thank you)
+ * Arguments -
+ *   string a_inputFileName : String of input file name
+ *   MazeSearchOptions& a_options : How to search
+ *   ostream& a_out : Stream the messages and solution are written to
+ *   ostream& a_err : Stream errors are written to
+ * Returns : 0 if the maze was solved (or shown to have no solution),
+ *         : FLAGRANT_ERROR if it could not be read or has no entrance
+ */
+int solveMazeFile(string a_inputFileName, MazeSearchOptions& a_options,
+		  ostream& a_out, ostream& a_err)
+{
   /** The maze array **/
   MazeMap mazeMap;
 
-  /** DISPLAY WELCOME AND READ IN MAZE MAP FROM FILE **/
-  cout << "Welcome to Merlin's wizardry, your highness!" << endl;
+  // Count and time this solve (reported with --stats)
+  resetMazeStats();
+  chrono::steady_clock::time_point phaseStart = chrono::steady_clock::now();
 
   // Check to see if input file is valid.
   // Read maze map from file into 2D array.
-  cout << "Reading secret map of \"" << inputFileName << "\" ..." << endl;
-  if(readMazeMapFile(mazeMap, inputFileName) == FLAGRANT_ERROR)
+  a_out << "Reading secret map of \"" << a_inputFileName << "\" ..." << endl;
+
+  // A maze solved the same way before is answered from the cache, without
+  // reading or searching it
+  MazeCacheKey cacheKey;
+  bool cacheable = (a_options.cache != NULL) &&
+    hashMazeFile(a_inputFileName, cacheKey.mazeHash, cacheKey.mazeBytes);
+  if(cacheable)
     {
-      cerr << "Input file cannot be read." << endl;
-      cerr << "Use a valid input file with form: 'MazeApp inputFile'" << endl;
-      exit(0);
+      cacheKey.engine = a_options.engine;
+      cacheKey.heuristic = a_options.heuristicName;
+      cacheKey.maxMemory = a_options.maxMemory;
+      cacheKey.precheck = a_options.precheck;
+
+      string cachedOutput;
+      if(lookupMazeCache(*a_options.cache, cacheKey, cachedOutput))
+	{
+	  mazeStats.loadMs = lapMilliseconds(phaseStart);
+	  a_out << "Trying now to find a solution... Please be patient..."
+		<< endl;
+	  a_out << cachedOutput;
+	  mazeStats.renderMs = lapMilliseconds(phaseStart);
+	  if(a_options.collectStats)
+	    displayMazeStats(a_inputFileName, a_out);
+	  return 0;
+	}
     }
 
-  cout << "Trying now to find a solution... Please be patient..." << endl;
+  if(readMazeMapFile(mazeMap, a_inputFileName) == FLAGRANT_ERROR)
+    {
+      a_err << "Input file cannot be read." << endl;
+      a_err << "Use a valid input file with form: 'MazeApp inputFile'" << endl;
+      return FLAGRANT_ERROR;
+    }
+
+  mazeStats.loadMs = lapMilliseconds(phaseStart);
+
+  a_out << "Trying now to find a solution... Please be patient..." << endl;
+
+  // What is shown from here on is also kept for the cache
+  ostringstream cachedOut;
+  ostream& solvedOut = cacheable ? (ostream&)cachedOut : a_out;
 
   /** FIND SOLUTION **/
-  Stack<Move*> feasibleMoveStack;
+
+  // Every Move of the solve comes from (and is freed with) this pool
+  Pool<Move> movePool;
+
   Stack<Move*> moveStack;
   Stack<Move*> backtrackStack;
 
-  MazeCursor mazeCursor;
-  Move* prevMove;
-
-  MazeMap mazeMapSolution;
-  copyMazeMap(mazeMap, mazeMapSolution);
+  // The solution, two bits per move
+  PackedPath solution;
 
   Position entrancePos;
-  bool solvable;
+  Position dragonPos;
+  vector<Position> dragons;
   bool foundDragon;
+  long expanded = -1;
+  bool hitMemoryLimit = false;
 
   // Add the follow to "cursor"?:
   if( !(findMazeMapEntrance(entrancePos, mazeMap)) )
     {
-      cerr << "No entrances have been located on the map!" << endl;
-      cerr << "Use a valid map (that is, one with an entrance!)." << endl;
-      exit(0);
+      a_err << "No entrances have been located on the map!" << endl;
+      a_err << "Use a valid map (that is, one with an entrance!)." << endl;
+      destroyMazeMap(mazeMap);
+      return FLAGRANT_ERROR;
     }
 
-  // Initialize route information
-  mazeCursor.currPos.x = entrancePos.x;
-  mazeCursor.currPos.y = entrancePos.y;
-  mazeCursor.prevPos.x = -1;
-  mazeCursor.prevPos.y = -1;
-  solvable = 1;
-  foundDragon = 0;
+  if(a_options.engine == ENGINE_MULTI_SOURCE)
+    {
+      // Every dragon gets its own answer, so there's no single solution
+      displayDragonRoutes(mazeMap, solvedOut);
+      mazeStats.solveMs = lapMilliseconds(phaseStart);
+      if(cacheable)
+	{
+	  string output = cachedOut.str();
+	  a_out << output;
+	  storeMazeCache(*a_options.cache, cacheKey, output);
+	}
+      if(a_options.collectStats)
+	displayMazeStats(a_inputFileName, a_out);
+      destroyMazeMap(mazeMap);
+      return 0;
+    }
 
-  // Look through moves!
-  do
+  if( a_options.precheck && !(dragonIsReachable(mazeMap, entrancePos)) )
     {
-      // If the dragon is here, we're done!
-      if( dragonIsHere(mazeMap, mazeCursor)  )
+      // No need to search: the flood fill found no way to a dragon
+      foundDragon = false;
+      if(a_options.engine != ENGINE_DFS)
+	expanded = 0;
+    }
+  else if(a_options.engine != ENGINE_DFS)
+    {
+      MazeSearchResult result;
+
+      if(a_options.engine == ENGINE_BFS)
+	result = solveMazeBFS(mazeMap, entrancePos);
+      else if(a_options.engine == ENGINE_PARALLEL_BFS)
+	result = solveMazeParallelBFS(mazeMap, entrancePos,
+				      a_options.threadCount);
+      else if(a_options.engine == ENGINE_JUNCTIONS)
+	result = solveMazeJunctions(mazeMap, entrancePos);
+      else if( !(findMazeMapDragon(dragonPos, mazeMap)) )
 	{
-	  //cout << "Dragon found!" << endl;
-	  foundDragon = 1;	  
+	  // No dragon, so there's nothing to aim for
+	  result.foundDragon = false;
+	  result.expanded = 0;
+	}
+      else if(a_options.engine == ENGINE_BIDIRECTIONAL)
+	{
+	  listMazeMapTiles(mazeMap, 'd', dragons);
+	  result = solveMazeBidirectional(mazeMap, entrancePos, dragons);
+	}
+      else if(a_options.engine == ENGINE_IDASTAR)
+	{
+	  listMazeMapTiles(mazeMap, 'd', dragons);
+	  result = solveMazeIDAStar(mazeMap, entrancePos, dragons,
+				    a_options.heuristic, a_options.maxMemory,
+				    hitMemoryLimit);
+	}
+      else if(a_options.engine == ENGINE_JUMP_POINTS)
+	{
+	  listMazeMapTiles(mazeMap, 'd', dragons);
+	  result = solveMazeJumpPoints(mazeMap, entrancePos, dragons,
+				       a_options.heuristic);
 	}
-      // Dragon is not here!  We are not done!
       else
 	{
-	  if( canMove(mazeMap, mazeCursor, moveStack, feasibleMoveStack) )
-	    {
-	      makeMove(mazeCursor, feasibleMoveStack, moveStack);
-	    }
-	  else // otherwise, backtrack
-	    {
-	      // Make sure move stack isn't empty!
-	      if( feasibleMoveStack.isEmptyStack() && !(moveStack.isEmptyStack()) )
-		{
-		  solvable = 0;
-		}
-	      else
-		{
-		  if( !(moveStack.isEmptyStack()) )
-		    {
-		      backtrack(feasibleMoveStack, moveStack, backtrackStack);
-		      makeMove(mazeCursor, feasibleMoveStack, moveStack);
-		    }
-		}
-	    }
+	  listMazeMapTiles(mazeMap, 'd', dragons);
+	  result = solveMazeAStar(mazeMap, entrancePos, dragons,
+				  a_options.heuristic);
 	}
-    } while( (foundDragon == 0) && (solvable == 1) );
 
-  if( (foundDragon == 1) && (solvable == 1) )
+      foundDragon = result.foundDragon;
+      expanded = result.expanded;
+      solution = result.path;
+    }
+  else
+    {
+      foundDragon = solveMazeDFS(mazeMap, entrancePos, moveStack,
+				 backtrackStack, movePool);
+      if(foundDragon)
+	packMoveStack(entrancePos, moveStack, solution);
+    }
+
+  mazeStats.solveMs = lapMilliseconds(phaseStart);
+  mazeStats.cellsExpanded = expanded;
+
+  if(foundDragon)
     {
       /** DISPLAY SOLUTION **/
-      cout << "Here is the solution: ";
-      displaySolutionMoves(moveStack);
+      solvedOut << "Here is the solution: ";
+      displaySolutionMoves(solution, solvedOut);
+
+      solvedOut << "The solution is maze form:" << endl;
+      displayMazeMapSolution(mazeMap, solution, backtrackStack, solvedOut);
 
-      cout << "The solution is maze form:" << endl;
-      displayMazeMapSolution(mazeMap, moveStack, backtrackStack);
+      if(hitMemoryLimit)
+	solvedOut << "Some paths were too long for the memory limit, so a "
+		  << "shorter solution may exist." << endl;
+    }
+  else if(hitMemoryLimit)
+    {
+      solvedOut << "No solution can be found within the memory limit.  "
+		<< "Try a larger --max-memory." << endl;
     }
   else
     {
-      cout << "No solution can be found.  "
-	   << "The dragon is too sneaky, and it will surely eat you." << endl;
+      solvedOut << "No solution can be found.  "
+		<< "The dragon is too sneaky, and it will surely eat you."
+		<< endl;
     }
 
-  cout << "Thank you for using merlin's MazeApp." << endl;
+  if(expanded >= 0)
+    solvedOut << "Cells explored: " << expanded << endl;
+
+  if(cacheable)
+    {
+      string output = cachedOut.str();
+      a_out << output;
+      storeMazeCache(*a_options.cache, cacheKey, output);
+    }
+
+  mazeStats.renderMs = lapMilliseconds(phaseStart);
+  if(a_options.collectStats)
+    displayMazeStats(a_inputFileName, a_out);
+
+  destroyMazeMap(mazeMap);
 
   return 0;
 }
 
+/*
+ * Purpose : Reads a number of bytes from the command line
+ * Arguments -
+ *   string a_text : The number, optionally followed by K, M or G (for
+ *                 : kilobytes, megabytes or gigabytes)
+ *   long long& a_bytes : Receives the number of bytes
+ * Returns : true if the text is such a number
+ */
+bool readByteCount(string a_text, long long& a_bytes)
+{
+  char* suffix;
+  a_bytes = strtoll(a_text.c_str(), &suffix, 10);
 
-//-----------------------------------------------------------------------------
-// Program functions
-//-----------------------------------------------------------------------------
+  if( (suffix == a_text.c_str()) || (a_bytes < 0) )
+    return false;
+
+  if( (*suffix == 'K') || (*suffix == 'k') )
+    a_bytes <<= 10;
+  else if( (*suffix == 'M') || (*suffix == 'm') )
+    a_bytes <<= 20;
+  else if( (*suffix == 'G') || (*suffix == 'g') )
+    a_bytes <<= 30;
+  else if(*suffix != '\0')
+    return false;
+
+  return (*suffix == '\0') || (suffix[1] == '\0');
+}
+
+/*
+ * Purpose : Finds whether the dragon can be reached, and maybe in how many
+ *         : moves, without loading the whole maze (for mazes bigger than
+ *         : memory)
+ * Arguments -
+ *   string a_inputFileName : String of input file name
+ *   long long a_bandRows : Rows solved at a time (0 to pick)
+ *   int a_maxSweeps : Most sweeps to spend on the path length (0 for none)
+ *   ostream& a_out : Stream the messages are written to
+ *   ostream& a_err : Stream errors are written to
+ * Returns : 0 if the maze was solved (or shown to have no solution),
+ *         : FLAGRANT_ERROR if it could not be read or has no entrance
+ */
+int streamMazeFile(string a_inputFileName, long long a_bandRows,
+		   int a_maxSweeps, ostream& a_out, ostream& a_err)
+{
+  MazeStreamResult result;
+
+  a_out << "Reading secret map of \"" << a_inputFileName
+	<< "\" a band at a time ..." << endl;
+  a_out << "Trying now to find a solution... Please be patient..." << endl;
+
+  if(solveMazeStream(a_inputFileName, a_bandRows, a_maxSweeps, result) ==
+     FLAGRANT_ERROR)
+    {
+      a_err << "Input file cannot be read." << endl;
+      a_err << "Use a valid input file whose rows are all the same length."
+	    << endl;
+      return FLAGRANT_ERROR;
+    }
+
+  if( !(result.foundEntrance) )
+    {
+      a_err << "No entrances have been located on the map!" << endl;
+      a_err << "Use a valid map (that is, one with an entrance!)." << endl;
+      return FLAGRANT_ERROR;
+    }
+
+  if( !(result.foundDragon) )
+    {
+      a_out << "No solution can be found.  "
+	    << "The dragon is too sneaky, and it will surely eat you." << endl;
+    }
+  else if(result.lengthExact)
+    {
+      a_out << "The dragon can be reached in " << result.length
+	    << " moves." << endl;
+    }
+  else if(result.length >= 0)
+    {
+      a_out << "The dragon can be reached in at most " << result.length
+	    << " moves (the sweeps stopped before they settled)." << endl;
+    }
+  else
+    {
+      a_out << "The dragon can be reached." << endl;
+      if(result.edgesTooBig)
+	a_out << "(Its distance would need more memory than the budget "
+	      << "allows.)" << endl;
+      else if(a_maxSweeps > 0)
+	a_out << "(No path length was found within " << a_maxSweeps
+	      << " sweeps.)" << endl;
+    }
+
+  a_out << "Bands of " << result.bandRows << " rows: " << result.bandCount
+	<< ", sweeps over them: " << result.sweeps << endl;
+
+  return 0;
+}
+
+/*
+ * Purpose : Writes a maze out in the binary or text format (either can be
+ *         : read in)
+ * Arguments -
+ *   string a_inputFileName : String of input file name
+ *   string a_outputFileName : String of output file name
+ *   bool a_toBinary : Write the binary format (else the text format)?
+ *   ostream& a_out : Stream the messages are written to
+ *   ostream& a_err : Stream errors are written to
+ * Returns : 0 if the maze was written, FLAGRANT_ERROR if it could not be
+ *         : read or written
+ */
+int convertMazeFile(string a_inputFileName, string a_outputFileName,
+		    bool a_toBinary, ostream& a_out, ostream& a_err)
+{
+  MazeMap mazeMap;
+
+  a_out << "Reading secret map of \"" << a_inputFileName << "\" ..." << endl;
+  if(readMazeMapFile(mazeMap, a_inputFileName) == FLAGRANT_ERROR)
+    {
+      a_err << "Input file cannot be read." << endl;
+      a_err << "Use a valid input file with form: 'MazeApp inputFile'" << endl;
+      return FLAGRANT_ERROR;
+    }
+
+  int written;
+  if(a_toBinary)
+    written = writeMazeBinaryFile(mazeMap, a_outputFileName);
+  else
+    written = writeMazeTextFile(mazeMap, a_outputFileName);
+
+  destroyMazeMap(mazeMap);
+
+  if(written == FLAGRANT_ERROR)
+    {
+      a_err << "Output file \"" << a_outputFileName << "\" cannot be written."
+	    << endl;
+      return FLAGRANT_ERROR;
+    }
+
+  a_out << "Copied the secret map to \"" << a_outputFileName << "\"." << endl;
+
+  return 0;
+}
+
+/*
+ * Purpose : Answers "path from here to the dragon" queries off a maze's
+ *         : distance field.  The field is read from the input file name
+ *         : plus ".field" if it was saved there for this same maze, and
+ *         : is otherwise worked out and saved there for next time.
+ * Arguments -
+ *   string a_inputFileName : String of input file name
+ *   vector<Position>& a_queries : Cells to find paths from
+ *   bool a_rebuildField : Work the field out even if one is saved?
+ *   ostream& a_out : Stream the messages and paths are written to
+ *   ostream& a_err : Stream errors are written to
+ * Returns : 0 if the queries were answered, FLAGRANT_ERROR if the maze
+ *         : could not be read
+ */
+int answerMazeQueries(string a_inputFileName, vector<Position>& a_queries,
+		      bool a_rebuildField, ostream& a_out, ostream& a_err)
+{
+  MazeMap mazeMap;
+
+  a_out << "Reading secret map of \"" << a_inputFileName << "\" ..." << endl;
+  if(readMazeMapFile(mazeMap, a_inputFileName) == FLAGRANT_ERROR)
+    {
+      a_err << "Input file cannot be read." << endl;
+      a_err << "Use a valid input file with form: 'MazeApp inputFile'" << endl;
+      return FLAGRANT_ERROR;
+    }
+
+  DistanceField field;
+  string fieldFileName = a_inputFileName + ".field";
+
+  if( a_rebuildField || !(loadDistanceField(field, fieldFileName)) ||
+      (field.mazeHash != hashMazeMap(mazeMap)) ||
+      (field.rows != mazeMap.rows) || (field.cols != mazeMap.cols) )
+    {
+      a_out << "Mapping the way to the dragon from everywhere..." << endl;
+      buildDistanceField(mazeMap, field);
+
+      if(saveDistanceField(field, fieldFileName))
+	a_out << "Distance field saved to \"" << fieldFileName << "\"."
+	      << endl;
+      else
+	a_err << "Distance field cannot be saved to \"" << fieldFileName
+	      << "\"." << endl;
+    }
+  else
+    {
+      a_out << "Using the distance field saved in \"" << fieldFileName
+	    << "\"." << endl;
+    }
+
+  destroyMazeMap(mazeMap);
+
+  PackedPath path;
+  for(unsigned int i = 0; i < a_queries.size(); i++)
+    {
+      a_out << "From row " << a_queries[i].x << ", column "
+	    << a_queries[i].y << ": ";
+
+      if(queryDistanceField(field, a_queries[i], path))
+	{
+	  a_out << path.getLength() << " moves" << endl;
+	  displaySolutionMoves(path, a_out);
+	}
+      else
+	{
+	  a_out << "the dragon cannot be reached" << endl;
+	}
+    }
+
+  return 0;
+}
+
+/*
+ * Purpose : Searches from every entrance at once and displays, for each
+ *         : dragon, the nearest entrance and the moves from it
+ * Arguments -
+ *   MazeMap& a_mazeMap : Reference to MazeMap
+ *   ostream& a_out : Stream to display on
+ */
+void displayDragonRoutes(MazeMap& a_mazeMap, ostream& a_out)
+{
+  vector<Position> entrances;
+  vector<Position> dragons;
+  listMazeMapTiles(a_mazeMap, 'e', entrances);
+  listMazeMapTiles(a_mazeMap, 'd', dragons);
+
+  vector<DragonRoute> routes(dragons.size());
+  for(unsigned int i = 0; i < dragons.size(); i++)
+    routes[i].dragon = dragons[i];
+
+  long expanded = solveMazeMultiSource(a_mazeMap, entrances, routes);
+
+  if(routes.size() == 0)
+    {
+      a_out << "No solution can be found.  "
+	    << "The dragon is too sneaky, and it will surely eat you." << endl;
+    }
+
+  for(unsigned int i = 0; i < routes.size(); i++)
+    {
+      a_out << "Dragon at row " << routes[i].dragon.x << ", column "
+	    << routes[i].dragon.y << ": ";
+
+      if(routes[i].reached)
+	{
+	  Position start = routes[i].path.getStart();
+	  a_out << "nearest entrance at row " << start.x << ", column "
+		<< start.y << ", " << routes[i].path.getLength() << " moves"
+		<< endl;
+	  displaySolutionMoves(routes[i].path, a_out);
+	}
+      else
+	{
+	  a_out << "no entrance can reach it" << endl;
+	}
+    }
+
+  a_out << "Cells explored: " << expanded << endl;
+}
 
 /*
  * Purpose : Displays a maze map in the form of a 2D array
  * Arguments -
  *   MazeMap& a_mazeMap : Reference to MazeMap
+ *   ostream& a_out : Stream to display on
  */
-void displayMazeMap(MazeMap& a_mazeMap)
+void displayMazeMap(MazeMap& a_mazeMap, ostream& a_out)
 {
   for(int i = 0; i < a_mazeMap.rows; i++)
     {
       for(int j = 0; j < a_mazeMap.cols; j++)
 	{
-	  cout << a_mazeMap.map[i][j];
+	  a_out << mazeMapCell(a_mazeMap, i, j);
 	}
-      cout << endl;
+      a_out << endl;
     }
 }
 
 /*
  * Purpose : Displays the maze map with the solution and backtrack information
- *         : indicated
+ *         : indicated.  The marks are stamped into a copy of the map (one
+ *         : pass over each path), and the copy is written out in one go.
  * Arguments -
  *   MazeMap& a_mazeMap : Reference to a MazeMap
- *   Stack<Move*>& a_moveStack : Reference to a Stack of Move pointers
+ *   PackedPath& a_solution : Reference to the solution path
  *   Stack<Move*>& a_backtrackStack : Reference to Stack of Move pointers
+ *   ostream& a_out : Stream to display on
  */
-void displayMazeMapSolution(MazeMap& a_mazeMap, Stack<Move*>& a_moveStack,
-			    Stack<Move*>& a_backtrackStack)
+void displayMazeMapSolution(MazeMap& a_mazeMap, PackedPath& a_solution,
+			    Stack<Move*>& a_backtrackStack, ostream& a_out)
 {
-  bool solutionFlag = 0;
-  bool backtrackFlag = 0;
+  size_t lineLength = a_mazeMap.cols + 1; // row plus newline
+  char* overlay = new char[a_mazeMap.rows * lineLength];
 
+  for(int i = 0; i < a_mazeMap.rows; i++)
+    {
+      memcpy(&overlay[i * lineLength], &mazeMapCell(a_mazeMap, i, 0),
+	     a_mazeMap.cols);
+      overlay[i * lineLength + a_mazeMap.cols] = '\n';
+    }
+
+  // Stamp backtracked cells first, so the solution wins where they overlap
+  Move* pMove = NULL;
+  if( !(a_backtrackStack.isEmptyStack()) )
+    pMove = a_backtrackStack.top();
+
+  while(pMove != NULL)
+    {
+      overlay[pMove->getPosition().x * lineLength +
+	      pMove->getPosition().y] = 'b';
+      pMove = pMove->getPrevious();
+    }
+
+  // Replay the solution (the start itself is not marked)
+  Position pos = a_solution.getStart();
+  for(long k = 0; k < a_solution.getLength(); k++)
+    {
+      pos = PackedPath::step(pos, a_solution.getMove(k));
+      overlay[pos.x * lineLength + pos.y] = 's';
+    }
+
+  // The dragon shows through everything
   for(int i = 0; i < a_mazeMap.rows; i++)
     {
       for(int j = 0; j < a_mazeMap.cols; j++)
 	{
-	  solutionFlag = 0;
-	  backtrackFlag = 0;
-	  
-	  Move* pMove = NULL;
+	  if( mazeMapCell(a_mazeMap, i, j) == 'd' )
+	    overlay[i * lineLength + j] = 'x';
+	}
+    }
 
-	  if( !(a_moveStack.isEmptyStack()) )
-	    pMove = a_moveStack.top();
+  a_out.write(overlay, a_mazeMap.rows * lineLength);
+  a_out.flush();
 
-	  while(pMove != NULL)
-	    {
-	      if( (i == pMove->getPosition().x) &&
-		  (j == pMove->getPosition().y) )
-		{
-		  solutionFlag = 1;
-		}
-	      pMove = pMove->getPrevious();
-	    }
-
-	  if( !(a_backtrackStack.isEmptyStack()) )
-	    pMove = a_backtrackStack.top();
+  delete [] overlay;
+}
 
-	  while(pMove != NULL)
-	    {
-	      if( (i == pMove->getPosition().x) &&
-		  (j == pMove->getPosition().y) )
-		{
-		  backtrackFlag = 1;
-		}
-	      pMove = pMove->getPrevious();
-	    }
+/*
+ * Purpose : Displays solution as a sequence of Move ID symbols
+ * Arguments -
+ *   PackedPath& a_solution : Reference to the solution path
+ *   ostream& a_out : Stream to display on
+ */
+void displaySolutionMoves(PackedPath& a_solution, ostream& a_out)
+{
+  if(a_solution.getLength() > 0)
+    {
+      for(long i = 0; i < a_solution.getLength(); i++)
+	{
+	  if(i > 0)
+	    a_out << "-";
 
-	  if( a_mazeMap.map[i][j] == 'd' )
-	    cout << "x";
-	  else if( solutionFlag == 1 )
-	    cout << "s";
-	  else if( backtrackFlag == 1 )
-	    cout << "b";
-	  else
-	    cout << a_mazeMap.map[i][j];
+	  a_out << a_solution.getMove(i);
 	}
-      cout << endl;
+      a_out << endl;
     }
 }
 
 /*
- * Purpose : Displays solution as a sequence of Move ID symbols
+ * Purpose : Packs the chain of Moves on a move stack into a PackedPath
  * Arguments -
+ *   Position a_entrancePos : Position the moves start from
  *   Stack<Move*>& a_moveStack : Reference to a Stack of Move pointers
+ *   PackedPath& a_solution : Receives the moves, first to last
  */
-void displaySolutionMoves(Stack<Move*>& a_moveStack)
+void packMoveStack(Position a_entrancePos, Stack<Move*>& a_moveStack,
+		   PackedPath& a_solution)
 {
-  Stack<char> tmpMoveSeqStack;
+  a_solution.setStart(a_entrancePos.x, a_entrancePos.y);
+  a_solution.resize(a_moveStack.size());
 
+  // The chain runs from the last move back to the first
+  long i = a_moveStack.size();
   Move* pMove = NULL;
   if( !(a_moveStack.isEmptyStack()) )
-    {
-      Move* pMove = a_moveStack.top();
-
-      // Get remaining moves
-      while(pMove != NULL)
-	{
-	  tmpMoveSeqStack.push(pMove->getID());
-	  pMove = pMove->getPrevious();
-	}
-
-      while( !(tmpMoveSeqStack.isEmptyStack()) )
-	{
-	  cout << tmpMoveSeqStack.top();
-	  tmpMoveSeqStack.pop();
+    pMove = a_moveStack.top();
 
-	  if( !(tmpMoveSeqStack.isEmptyStack()) )
-	    cout << "-";
-	}
-      cout << endl;
+  while( (pMove != NULL) && (i > 0) )
+    {
+      i--;
+      a_solution.setMove(i, pMove->getID());
+      pMove = pMove->getPrevious();
     }
 }
 
@@ -288,23 +927,112 @@ void displaySolutionMoves(Stack<Move*>& a_moveStack)
  */
 bool findMazeMapEntrance(Position& a_entrancePos, MazeMap& a_mazeMap)
 {
-  int count = 0;
+  // scanMazeMap() looked for it while the map was loaded
+  if( !(a_mazeMap.hasEntrance) )
+    return false;
+
+  a_entrancePos = a_mazeMap.entrancePos;
+  return true;
+}
+
+/*
+ * Purpose : Finds a path from the entrance to the dragon using depth-first
+ *         : search with backtracking
+ * Arguments -
+ *   MazeMap& a_mazeMap : Reference to a MazeMap
+ *   Position a_entrancePos : Position to start searching from
+ *   Stack<Move*>& a_moveStack : Receives the moves on the path
+ *   Stack<Move*>& a_backtrackStack : Receives the moves backtracked over
+ *   Pool<Move>& a_movePool : Pool every Move is allocated from
+ * Returns : Truth value indicating whether the dragon was found
+ */
+bool solveMazeDFS(MazeMap& a_mazeMap, Position a_entrancePos,
+		  Stack<Move*>& a_moveStack, Stack<Move*>& a_backtrackStack,
+		  Pool<Move>& a_movePool)
+{
+  Stack<Move*> feasibleMoveStack;
 
-  for(int row = 0; row < a_mazeMap.rows; row++)
+  // Reserve one slot per cell up front (the path can't be longer), so
+  // deep corridors rarely reallocate the stacks
+  int cells = a_mazeMap.rows * a_mazeMap.cols;
+
+  // Allocate visited flags (nothing has been visited yet)
+  if(a_mazeMap.visited == NULL)
+    a_mazeMap.visited = new bool[cells]();
+
+  feasibleMoveStack.reserve(cells);
+  a_moveStack.reserve(cells);
+
+  MazeCursor mazeCursor;
+  bool solvable;
+  bool foundDragon;
+
+  // Initialize route information
+  mazeCursor.currPos.x = a_entrancePos.x;
+  mazeCursor.currPos.y = a_entrancePos.y;
+  mazeCursor.prevPos.x = -1;
+  mazeCursor.prevPos.y = -1;
+  solvable = 1;
+  foundDragon = 0;
+
+  // Look through moves!
+  do
     {
-      for(int col = 0; col < a_mazeMap.cols; col++)
+      // If the dragon is here, we're done!
+      if( dragonIsHere(a_mazeMap, mazeCursor)  )
 	{
-	  if(a_mazeMap.map[row][col] == 'e')
+	  //cout << "Dragon found!" << endl;
+	  foundDragon = 1;	  
+	}
+      // Dragon is not here!  We are not done!
+      else
+	{
+	  if( canMove(a_mazeMap, mazeCursor, feasibleMoveStack, a_movePool) )
 	    {
-	      a_entrancePos.x = row;
-	      a_entrancePos.y = col;
-	      
-	      return true;
+	      makeMove(a_mazeMap, mazeCursor, feasibleMoveStack, a_moveStack,
+		       a_movePool);
+	    }
+	  else // otherwise, backtrack
+	    {
+	      // No move is left to backtrack to (this includes an entrance
+	      // that is walled in, where no move was ever made)
+	      if( feasibleMoveStack.isEmptyStack() )
+		{
+		  solvable = 0;
+		}
+	      else
+		{
+		  if( !(a_moveStack.isEmptyStack()) )
+		    {
+		      backtrack(feasibleMoveStack, a_moveStack, a_backtrackStack);
+		      makeMove(a_mazeMap, mazeCursor, feasibleMoveStack,
+			       a_moveStack, a_movePool);
+		    }
+		}
 	    }
 	}
-    }
+    } while( (foundDragon == 0) && (solvable == 1) );
 
-  return false;
+  return (foundDragon == 1) && (solvable == 1);
+}
+
+/*
+ * Purpose : Locates the dragon indicated by the 'd' symbol (the first one,
+ *         : if there are several)
+ * Arguments -
+ *   Position& a_dragonPos : Reference to Position indicator
+ *                         : that will hold the dragon position
+ *   MazeMap& a_mazeMap : Reference to a MazeMap
+ * Returns : Truth value indicating whether a dragon was found
+ */
+bool findMazeMapDragon(Position& a_dragonPos, MazeMap& a_mazeMap)
+{
+  // scanMazeMap() looked for it while the map was loaded
+  if( !(a_mazeMap.hasDragon) )
+    return false;
+
+  a_dragonPos = a_mazeMap.dragonPos;
+  return true;
 }
 
 /*
@@ -313,36 +1041,38 @@ bool findMazeMapEntrance(Position& a_entrancePos, MazeMap& a_mazeMap)
  *   MazeMap& a_mazeMap : Reference to a MazeMap
  *   MazeCursor&a_mazeCursor : Reference to a MazeCursor
  *   Stack<Move*>& a_feasibleMoveStack : Stack of Move pointers
+ *   Pool<Move>& a_movePool : Pool feasible Moves are allocated from
  * Returns : Truth value indicating whether a move can be made
  */
 bool canMove(MazeMap& a_mazeMap, MazeCursor& a_mazeCursor,
-	     Stack<Move*>& a_moveStack,
-	     Stack<Move*>& a_feasibleMoveStack)
+	     Stack<Move*>& a_feasibleMoveStack, Pool<Move>& a_movePool)
 {
   bool tmp_areFeasibleMoves = 0;
 
+  MAZE_STAT_ADD(canMoveCalls, 1);
+
   // Look South
-  if( canMoveSouth(a_mazeMap, a_mazeCursor, a_moveStack) )
+  if( canMoveSouth(a_mazeMap, a_mazeCursor) )
     {
-      addMoveSouth(a_mazeCursor, a_feasibleMoveStack);
+      addMoveSouth(a_mazeCursor, a_feasibleMoveStack, a_movePool);
       tmp_areFeasibleMoves = 1;
     }
   // Look West
-  if( canMoveWest(a_mazeMap, a_mazeCursor, a_moveStack) )
+  if( canMoveWest(a_mazeMap, a_mazeCursor) )
     {
-      addMoveWest(a_mazeCursor, a_feasibleMoveStack);
+      addMoveWest(a_mazeCursor, a_feasibleMoveStack, a_movePool);
       tmp_areFeasibleMoves = 1;
     }
   // Look North
-  if( canMoveNorth(a_mazeMap, a_mazeCursor, a_moveStack) )
+  if( canMoveNorth(a_mazeMap, a_mazeCursor) )
     {
-      addMoveNorth(a_mazeCursor, a_feasibleMoveStack);
+      addMoveNorth(a_mazeCursor, a_feasibleMoveStack, a_movePool);
       tmp_areFeasibleMoves = 1;
     }
   // Look East
-  if( canMoveEast(a_mazeMap, a_mazeCursor, a_moveStack) )
+  if( canMoveEast(a_mazeMap, a_mazeCursor) )
     {
-      addMoveEast(a_mazeCursor, a_feasibleMoveStack);
+      addMoveEast(a_mazeCursor, a_feasibleMoveStack, a_movePool);
       tmp_areFeasibleMoves = 1;
     }
   
@@ -358,8 +1088,8 @@ bool canMove(MazeMap& a_mazeMap, MazeCursor& a_mazeCursor,
  */
 bool dragonIsHere(MazeMap& a_mazeMap, MazeCursor& a_mazeCursor)
 {
-  if( tolower(a_mazeMap.map[a_mazeCursor.currPos.x][a_mazeCursor.currPos.y] )
-      == 'd' )
+  if( tolower(mazeMapCell(a_mazeMap, a_mazeCursor.currPos.x,
+			  a_mazeCursor.currPos.y)) == 'd' )
     return true;
   else
     return false;
@@ -372,16 +1102,18 @@ bool dragonIsHere(MazeMap& a_mazeMap, MazeCursor& a_mazeCursor)
  * Arguments -
  *   MazeCursor& a_mazeCursor : Reference ot MazeCursor
  *   Stack<Move*>& a_feasibleMoveStack : Reference to Stack of Move pointers
+ *   Pool<Move>& a_movePool : Pool the Move is allocated from
  */
-void addMoveEast(MazeCursor& a_mazeCursor, Stack<Move*>& a_feasibleMoveStack)
+void addMoveEast(MazeCursor& a_mazeCursor, Stack<Move*>& a_feasibleMoveStack,
+                 Pool<Move>& a_movePool)
 {
   Move* pPrevMove = NULL;
   if( !(a_feasibleMoveStack.isEmptyStack()) )
     pPrevMove = a_feasibleMoveStack.top();
 
-  Move* pNewMove =
-    new Move(EAST, a_mazeCursor.currPos.x, a_mazeCursor.currPos.y,
-	     pPrevMove, 0);
+  Move* pNewMove = new (a_movePool.allocate())
+    Move(EAST, a_mazeCursor.currPos.x, a_mazeCursor.currPos.y, pPrevMove, 0);
+  MAZE_STAT_ADD(moveAllocations, 1);
 
   a_feasibleMoveStack.push(pNewMove);
 }
@@ -393,8 +1125,7 @@ void addMoveEast(MazeCursor& a_mazeCursor, Stack<Move*>& a_feasibleMoveStack)
  *   MazeCursor& a_mazeCursor : Reference to MazeCursor
  * Returns : Truth value indicating whether move is feasible
  */
-bool canMoveEast(MazeMap& a_mazeMap, MazeCursor& a_mazeCursor,
-		 Stack<Move*>& a_moveStack)
+bool canMoveEast(MazeMap& a_mazeMap, MazeCursor& a_mazeCursor)
 {
   // Are we still in bounds of the maze?
   if( a_mazeCursor.currPos.y+1 < a_mazeMap.cols )
@@ -402,13 +1133,10 @@ bool canMoveEast(MazeMap& a_mazeMap, MazeCursor& a_mazeCursor,
       if( a_mazeCursor.currPos.y+1 != a_mazeCursor.prevPos.y )
 	{
 	  // Check to see if there is a wall to the east
-	  if(((a_mazeMap.map[a_mazeCursor.currPos.x][a_mazeCursor.currPos.y+1]
-	       == ' ') ||
-	      (a_mazeMap.map[a_mazeCursor.currPos.x][a_mazeCursor.currPos.y+1]
-	       == 'd') ) &&
-	     (!(moveAlreadyMade(a_mazeCursor.currPos.x,
-				a_mazeCursor.currPos.y+1,
-				a_moveStack))))
+	  if( mazeMapOpenTile(a_mazeMap, a_mazeCursor.currPos.x,
+			      a_mazeCursor.currPos.y+1) &&
+	      !(moveAlreadyMade(a_mazeMap, a_mazeCursor.currPos.x,
+				a_mazeCursor.currPos.y+1)) )
 	    {
 	      // Moving east is feasible, so return true!
 	      return true;
@@ -425,16 +1153,18 @@ bool canMoveEast(MazeMap& a_mazeMap, MazeCursor& a_mazeCursor,
  * Arguments -
  *   MazeCursor& a_mazeCursor : Reference ot MazeCursor
  *   Stack<Move*>& a_feasibleMoveStack : Reference to Stack of Move pointers
+ *   Pool<Move>& a_movePool : Pool the Move is allocated from
  */
-void addMoveNorth(MazeCursor& a_mazeCursor, Stack<Move*>& a_feasibleMoveStack)
+void addMoveNorth(MazeCursor& a_mazeCursor, Stack<Move*>& a_feasibleMoveStack,
+                  Pool<Move>& a_movePool)
 {
   Move* pPrevMove = NULL;
   if( !(a_feasibleMoveStack.isEmptyStack()) )
     pPrevMove = a_feasibleMoveStack.top();
 
-  Move* pNewMove =
-    new Move(NORTH, a_mazeCursor.currPos.x, a_mazeCursor.currPos.y,
-	     pPrevMove, 0);
+  Move* pNewMove = new (a_movePool.allocate())
+    Move(NORTH, a_mazeCursor.currPos.x, a_mazeCursor.currPos.y, pPrevMove, 0);
+  MAZE_STAT_ADD(moveAllocations, 1);
   a_feasibleMoveStack.push(pNewMove);
 }
 
@@ -445,8 +1175,7 @@ void addMoveNorth(MazeCursor& a_mazeCursor, Stack<Move*>& a_feasibleMoveStack)
  *   MazeCursor& a_mazeCursor : Reference to MazeCursor
  * Returns : Truth value indicating whether move is feasible
  */
-bool canMoveNorth(MazeMap& a_mazeMap, MazeCursor& a_mazeCursor,
-		  Stack<Move*>& a_moveStack)
+bool canMoveNorth(MazeMap& a_mazeMap, MazeCursor& a_mazeCursor)
 {
   // Are we still in bounds of the maze?
   if( a_mazeCursor.currPos.x-1 >= 0 )
@@ -454,13 +1183,10 @@ bool canMoveNorth(MazeMap& a_mazeMap, MazeCursor& a_mazeCursor,
       if( a_mazeCursor.currPos.x-1 != a_mazeCursor.prevPos.x )
         {
           // Check to see if there is a wall to the north
-	  if(((a_mazeMap.map[a_mazeCursor.currPos.x-1][a_mazeCursor.currPos.y]
-	       == ' ') ||
-	      (a_mazeMap.map[a_mazeCursor.currPos.x-1][a_mazeCursor.currPos.y]
-	       == 'd') ) &&
-	     (!(moveAlreadyMade(a_mazeCursor.currPos.x-1,
-				a_mazeCursor.currPos.y,
-				a_moveStack))))
+	  if( mazeMapOpenTile(a_mazeMap, a_mazeCursor.currPos.x-1,
+			      a_mazeCursor.currPos.y) &&
+	      !(moveAlreadyMade(a_mazeMap, a_mazeCursor.currPos.x-1,
+				a_mazeCursor.currPos.y)) )
 
             {
               // Moving north is feasible, so return true!
@@ -478,16 +1204,18 @@ bool canMoveNorth(MazeMap& a_mazeMap, MazeCursor& a_mazeCursor,
  * Arguments -
  *   MazeCursor& a_mazeCursor : Reference ot MazeCursor
  *   Stack<Move*>& a_feasibleMoveStack : Reference to Stack of Move pointers
+ *   Pool<Move>& a_movePool : Pool the Move is allocated from
  */
-void addMoveWest(MazeCursor& a_mazeCursor, Stack<Move*>& a_feasibleMoveStack)
+void addMoveWest(MazeCursor& a_mazeCursor, Stack<Move*>& a_feasibleMoveStack,
+                 Pool<Move>& a_movePool)
 {
   Move* pPrevMove = NULL;
   if( !(a_feasibleMoveStack.isEmptyStack()) )
     pPrevMove = a_feasibleMoveStack.top();
 
-  Move* pNewMove =
-    new Move(WEST, a_mazeCursor.currPos.x, a_mazeCursor.currPos.y,
-	     pPrevMove, 0);
+  Move* pNewMove = new (a_movePool.allocate())
+    Move(WEST, a_mazeCursor.currPos.x, a_mazeCursor.currPos.y, pPrevMove, 0);
+  MAZE_STAT_ADD(moveAllocations, 1);
   a_feasibleMoveStack.push(pNewMove);
 }
 
@@ -498,8 +1226,7 @@ void addMoveWest(MazeCursor& a_mazeCursor, Stack<Move*>& a_feasibleMoveStack)
  *   MazeCursor& a_mazeCursor : Reference to MazeCursor
  * Returns : Truth value indicating whether move is feasible
  */
-bool canMoveWest(MazeMap& a_mazeMap, MazeCursor& a_mazeCursor,
-		 Stack<Move*>& a_moveStack)
+bool canMoveWest(MazeMap& a_mazeMap, MazeCursor& a_mazeCursor)
 {
   // Are we still in bounds of the maze?
   if( a_mazeCursor.currPos.y-1 >= 0 )
@@ -507,13 +1234,10 @@ bool canMoveWest(MazeMap& a_mazeMap, MazeCursor& a_mazeCursor,
       if( a_mazeCursor.currPos.y-1 != a_mazeCursor.prevPos.y )
         {
           // Check to see if there is a wall to the west
-	  if(((a_mazeMap.map[a_mazeCursor.currPos.x][a_mazeCursor.currPos.y-1]
-               == ' ') ||
-              (a_mazeMap.map[a_mazeCursor.currPos.x][a_mazeCursor.currPos.y-1]
-               == 'd') ) &&
-             (!(moveAlreadyMade(a_mazeCursor.currPos.x,
-                                a_mazeCursor.currPos.y-1,
-				a_moveStack))))
+	  if( mazeMapOpenTile(a_mazeMap, a_mazeCursor.currPos.x,
+			      a_mazeCursor.currPos.y-1) &&
+	      !(moveAlreadyMade(a_mazeMap, a_mazeCursor.currPos.x,
+				a_mazeCursor.currPos.y-1)) )
 
             {
               // Moving west is feasible, so return true!
@@ -531,16 +1255,18 @@ bool canMoveWest(MazeMap& a_mazeMap, MazeCursor& a_mazeCursor,
  * Arguments -
  *   MazeCursor& a_mazeCursor : Reference ot MazeCursor
  *   Stack<Move*>& a_feasibleMoveStack : Reference to Stack of Move pointers
+ *   Pool<Move>& a_movePool : Pool the Move is allocated from
  */
-void addMoveSouth(MazeCursor& a_mazeCursor, Stack<Move*>& a_feasibleMoveStack)
+void addMoveSouth(MazeCursor& a_mazeCursor, Stack<Move*>& a_feasibleMoveStack,
+                  Pool<Move>& a_movePool)
 {
   Move* pPrevMove = NULL;
   if( !(a_feasibleMoveStack.isEmptyStack()) )
     pPrevMove = a_feasibleMoveStack.top();
 
-  Move* pNewMove =
-    new Move(SOUTH, a_mazeCursor.currPos.x, a_mazeCursor.currPos.y,
-	     pPrevMove, 0);
+  Move* pNewMove = new (a_movePool.allocate())
+    Move(SOUTH, a_mazeCursor.currPos.x, a_mazeCursor.currPos.y, pPrevMove, 0);
+  MAZE_STAT_ADD(moveAllocations, 1);
   a_feasibleMoveStack.push(pNewMove);
 }
 
@@ -551,8 +1277,7 @@ void addMoveSouth(MazeCursor& a_mazeCursor, Stack<Move*>& a_feasibleMoveStack)
  *   MazeCursor& a_mazeCursor : Reference to MazeCursor
  * Returns : Truth value indicating whether move is feasible
  */
-bool canMoveSouth(MazeMap& a_mazeMap, MazeCursor& a_mazeCursor,
-		  Stack<Move*>& a_moveStack)
+bool canMoveSouth(MazeMap& a_mazeMap, MazeCursor& a_mazeCursor)
 {
   // Are we still in bounds of the maze?
   if( a_mazeCursor.currPos.x+1 < a_mazeMap.rows )
@@ -560,13 +1285,10 @@ bool canMoveSouth(MazeMap& a_mazeMap, MazeCursor& a_mazeCursor,
       if( a_mazeCursor.currPos.x+1 != a_mazeCursor.prevPos.x )
         {
           // Check to see if there is a wall to the south
-	  if(((a_mazeMap.map[a_mazeCursor.currPos.x+1][a_mazeCursor.currPos.y]
-               == ' ') ||
-              (a_mazeMap.map[a_mazeCursor.currPos.x+1][a_mazeCursor.currPos.y]
-               == 'd') ) &&
-             (!(moveAlreadyMade(a_mazeCursor.currPos.x+1,
-                                a_mazeCursor.currPos.y,
-				a_moveStack))))
+	  if( mazeMapOpenTile(a_mazeMap, a_mazeCursor.currPos.x+1,
+			      a_mazeCursor.currPos.y) &&
+	      !(moveAlreadyMade(a_mazeMap, a_mazeCursor.currPos.x+1,
+				a_mazeCursor.currPos.y)) )
             {
               // Moving south is feasible, so return true!
               return true;
@@ -577,58 +1299,64 @@ bool canMoveSouth(MazeMap& a_mazeMap, MazeCursor& a_mazeCursor,
 }
 
 /*
- * Purpose : Indicates whether a move was already made
+ * Purpose : Indicates whether a move was already made (that is, whether the
+ *         : position has been visited).  This is a constant time lookup
+ *         : in the MazeMap's visited flags, which makeMove() sets.  They
+ *         : are not cleared on backtracking: everything reachable from
+ *         : a cell has been searched by the time it is backtracked out
+ *         : of, so it need not be entered again from elsewhere, and the
+ *         : search stays linear in the number of cells.
  * Arguments -
+ *   MazeMap& a_mazeMap : Reference to a MazeMap
  *   int a_xPos : x-coordinate
  *   int a_yPos : y-coordinate
- *   Stack<Move*>& a_moveStack : Reference to stack of moves
  * Returns : Truth value indicating whether move was made
  */
-bool moveAlreadyMade(int a_xPos, int a_yPos, Stack<Move*>& a_moveStack)
+bool moveAlreadyMade(MazeMap& a_mazeMap, int a_xPos, int a_yPos)
 {
-  bool tmpMoveAlreadyMade = 0;
-
-  Move* pTmpMovePtr = NULL;
-  if( !(a_moveStack.isEmptyStack()) )
-    pTmpMovePtr = a_moveStack.top();
-
-  while( (pTmpMovePtr != NULL) && (tmpMoveAlreadyMade == 0) )
-    {
-      if( (a_xPos == pTmpMovePtr->getPosition().x) &&
-	  (a_yPos == pTmpMovePtr->getPosition().y) )
-	{
-	  tmpMoveAlreadyMade = 1;
-	}
-      pTmpMovePtr = pTmpMovePtr->getPrevious();
-    }
-
-  return tmpMoveAlreadyMade;
+  MAZE_STAT_ADD(alreadyMadeLookups, 1);
+  return a_mazeMap.visited[mazeMapIndex(a_mazeMap, a_xPos, a_yPos)];
 }
 
 /*
  * Purpose : Makes a move
  * Arguments -
+ *   MazeMap& a_mazeMap : Reference to a MazeMap
  *   MazeCursor& a_mazeCursor : Reference to MazeCursor
  *   Stack<Move*>& a_feasibleMoveStack : Stack of Move pointers
  *   Stack<Move*>& a_moveStack : Stack of Move pointers
+ *   Pool<Move>& a_movePool : Pool the Move is allocated from (the feasible
+ *                          : Move it is copied from goes back to the pool)
  * Returns : Truth value indicating whether move is feasible
  */
-bool makeMove(MazeCursor& a_mazeCursor, Stack<Move*>& a_feasibleMoveStack,
-	      Stack<Move*>& a_moveStack)
+bool makeMove(MazeMap& a_mazeMap, MazeCursor& a_mazeCursor,
+	      Stack<Move*>& a_feasibleMoveStack, Stack<Move*>& a_moveStack,
+	      Pool<Move>& a_movePool)
 {
   bool madeMove = false;
 
+  MAZE_STAT_ADD(makeMoveCalls, 1);
+
   Move* pPrevMove = NULL;
   if( !(a_moveStack.isEmptyStack()) )
     pPrevMove = a_moveStack.top();
 
-  Move* pTmpMove = new Move(*a_feasibleMoveStack.top());
+  Move* pTmpMove =
+    new (a_movePool.allocate()) Move(*a_feasibleMoveStack.top());
+  MAZE_STAT_ADD(moveAllocations, 1);
   pTmpMove->setPrevious( pPrevMove );
   a_moveStack.push( pTmpMove );
+
+  // Feasible Moves found later may still point to this one as their
+  // previous Move, but those pointers are never followed (the copy above
+  // replaces its own), so recycle it
+  a_movePool.release( a_feasibleMoveStack.top() );
   a_feasibleMoveStack.pop();
 
-  a_mazeCursor.prevPos.x = a_mazeCursor.currPos.x;
-  a_mazeCursor.prevPos.y = a_mazeCursor.currPos.y;
+  // The move is made from where the feasible Move was found, which is not
+  // where the cursor is if we just backtracked
+  a_mazeCursor.prevPos.x = a_moveStack.top()->getPosition().x;
+  a_mazeCursor.prevPos.y = a_moveStack.top()->getPosition().y;
 
   if( a_moveStack.top()->getID() == EAST )
     {
@@ -657,18 +1385,29 @@ bool makeMove(MazeCursor& a_mazeCursor, Stack<Move*>& a_feasibleMoveStack,
   
   a_moveStack.top()->setPosition( a_mazeCursor.currPos.x,
 				  a_mazeCursor.currPos.y );
+
+  // Flag the new position as visited
+  a_mazeMap.visited[mazeMapIndex(a_mazeMap, a_mazeCursor.currPos.x,
+				a_mazeCursor.currPos.y)] = true;
   
   return madeMove;
 }
 
 /*
  * Purpose : Performs backtracking
+ * Arguments -
+ *   Stack<Move*>& a_feasibleMoveStack : Stack of Move pointers
+ *   Stack<Move*>& a_moveStack : Stack of Move pointers
+ *   Stack<Move*>& a_backtrackStack : Stack of Move pointers
  * Returns : Truth value indicating whether backtracking was performed
  */
 bool backtrack(Stack<Move*>& a_feasibleMoveStack, Stack<Move*>& a_moveStack,
 	       Stack<Move*>& a_backtrackStack)
 {
   bool backtracked = false;
+  long long depth = 0;
+
+  MAZE_STAT_ADD(backtrackCalls, 1);
 
   do
     {
@@ -686,17 +1425,22 @@ bool backtrack(Stack<Move*>& a_feasibleMoveStack, Stack<Move*>& a_moveStack,
 
       if( backtracked == false )
 	backtracked = true;
+      depth++;
     }
-  while( (a_moveStack.top()->getPosition().x !=
-	  a_feasibleMoveStack.top()->getPosition().x) ||
-	 (a_moveStack.top()->getPosition().y !=
-	  a_feasibleMoveStack.top()->getPosition().y) );
+  while( !(a_moveStack.isEmptyStack()) &&
+	 ((a_moveStack.top()->getPosition().x !=
+	   a_feasibleMoveStack.top()->getPosition().x) ||
+	  (a_moveStack.top()->getPosition().y !=
+	   a_feasibleMoveStack.top()->getPosition().y)) );
+
+  MAZE_STAT_ADD(backtrackMoves, depth);
+  MAZE_STAT_MAX(longestBacktrack, depth);
 
   return backtracked;
 }
 
 /*
- * Purpose : Reads maze map from file into 2D array
+ * Purpose : Reads maze map from file (in text or binary form) into 2D array
  * Arguments -
  *   MazeMap& a_mazeMap : Reference to MazeMap
  *   string a_inputFileName : String of input file name
@@ -706,6 +1450,23 @@ int readMazeMapFile(MazeMap& a_mazeMap, string a_inputFileName)
 {
   bool valid = 1; // Indicates whether input file is stil valid!
 
+  a_mazeMap.map = NULL;
+  a_mazeMap.visited = NULL;
+  a_mazeMap.mapping = NULL;
+  a_mazeMap.mappingLength = 0;
+  a_mazeMap.openBits = NULL;
+
+  // Binary maze files are told apart by the tag they start with
+  if(readMazeBinaryFile(a_mazeMap, a_inputFileName) == 0)
+    return 0;
+
+  // Well-formed files are used in place, without copying the tiles
+  if(mapMazeMapFile(a_mazeMap, a_inputFileName) == 0)
+    {
+      scanMazeMap(a_mazeMap);
+      return 0;
+    }
+
   ifstream inputFile(a_inputFileName.c_str());
 
   if( inputFile.good() )
@@ -719,46 +1480,47 @@ int readMazeMapFile(MazeMap& a_mazeMap, string a_inputFileName)
       strBuff.str(rowStr); // Load first input file line into input buffer
       
       // Extract rows and colums from input buffer
+      a_mazeMap.rows = 0;
+      a_mazeMap.cols = 0;
       strBuff >> a_mazeMap.rows >> a_mazeMap.cols;
 
-      /** ALLOCATE MEMORY FOR MAZE **/
-
-      // Allocate rows
-      a_mazeMap.map = new char*[a_mazeMap.rows];
-
-      // Allocate columns
-      int row=0, col=0;
-      for(row=0; row < a_mazeMap.rows; row++)
+      // Refuse sizes whose tiles can't all be indexed (the product is
+      // worked out in 64 bits, so it can't wrap around first)
+      if( (a_mazeMap.rows < 1) || (a_mazeMap.cols < 1) ||
+	  ((long long)a_mazeMap.rows * a_mazeMap.cols > MAZE_MAP_MAX_TILES) )
 	{
-	  a_mazeMap.map[row] = new char[a_mazeMap.cols];
+	  inputFile.close();
+	  return -1;
 	}
 
+      /** ALLOCATE MEMORY FOR MAZE **/
+
+      // Allocate all rows as one contiguous (row-major) block
+      size_t tiles = (size_t)a_mazeMap.rows * a_mazeMap.cols;
+      a_mazeMap.map = new char[tiles];
+      a_mazeMap.stride = a_mazeMap.cols;
+
       // Zero out map
-      for(row = 0; row < a_mazeMap.rows; row++)
-	{
-	  for(col = 0; col < a_mazeMap.cols; col++)
-	    {
-	      a_mazeMap.map[row][col] = ' ';
-	    }
-	}
+      memset(a_mazeMap.map, ' ', tiles);
+
+      int row=0;
 
-      row=0, col=0;
       for(int i = 0; (i < a_mazeMap.rows) && (!inputFile.eof()); i++)
 	{
-	  // Get row string!
+	  // Get row string!  (Drop the '\r' of DOS line endings)
 	  getline(inputFile, rowStr);
+	  if( (rowStr.length() > 0) && (rowStr[rowStr.length()-1] == '\r') )
+	    rowStr.erase(rowStr.length()-1);
 
 	  if(rowStr.length() > a_mazeMap.cols)
 	    valid = 0;
 
 	  if(valid == 1)
 	    {
-	      // Go through row and extract tiles!
-	      for(col = 0; col < a_mazeMap.cols; col++)
-		{
-		  a_mazeMap.map[row][col] = rowStr[col];
-		  // a_mazeMap.moveMap[row][col].setPosition(row,col);
-		}
+	      // Copy the row's tiles!  (Short rows are padded with the
+	      // spaces the map was zeroed with)
+	      memcpy(&mazeMapCell(a_mazeMap, row, 0), rowStr.data(),
+		     rowStr.length());
       
 	      // Increment so we use next row! (Go one row down)
 	      row++;
@@ -778,9 +1540,173 @@ int readMazeMapFile(MazeMap& a_mazeMap, string a_inputFileName)
     }
 
   if(valid == 1)
-    return 0;
+    {
+      scanMazeMap(a_mazeMap);
+      return 0;
+    }
   else
+    {
+      // A long-lived caller (server mode) may read many bad files
+      delete [] a_mazeMap.map;
+      a_mazeMap.map = NULL;
+      return -1;
+    }
+}
+
+/*
+ * Purpose : Reads the "rows cols" line at the start of a maze map file and
+ *         : works out where its rows are.  The first row's ending ("\n" or
+ *         : "\r\n") decides the stride of every row.
+ * Arguments -
+ *   const char* a_file : The file's contents (usually mapped)
+ *   size_t a_length : Length of the file in bytes
+ *   MazeMapLayout& a_layout : Receives the layout
+ * Returns : true if the line is well-formed and the file is long enough to
+ *         : hold every row
+ */
+bool readMazeMapLayout(const char* a_file, size_t a_length,
+		       MazeMapLayout& a_layout)
+{
+  size_t pos = 0;
+
+  /** READ IN FIRST LINE OF FILE (ROWS/COLS) **/
+
+  long dims[2] = { 0, 0 };
+  bool valid = true;
+
+  for(int d = 0; (d < 2) && valid; d++)
+    {
+      while( (pos < a_length) && (a_file[pos] == ' ') )
+	pos++;
+
+      if( (pos == a_length) || (a_file[pos] < '0') || (a_file[pos] > '9') )
+	valid = false;
+
+      while( valid && (pos < a_length) && (a_file[pos] >= '0') &&
+	     (a_file[pos] <= '9') && (dims[d] <= 1000000000L) )
+	{
+	  dims[d] = dims[d] * 10 + (a_file[pos] - '0');
+	  pos++;
+	}
+    }
+
+  while( valid && (pos < a_length) && (a_file[pos] == ' ') )
+    pos++;
+  if( valid && (pos < a_length) && (a_file[pos] == '\r') )
+    pos++;
+  if( !valid || (pos == a_length) || (a_file[pos] != '\n') )
+    return false;
+  pos++;
+
+  a_layout.rows = dims[0];
+  a_layout.cols = dims[1];
+  a_layout.dataStart = pos;
+  if( (a_layout.rows < 1) || (a_layout.cols < 1) ||
+      (pos + a_layout.cols > a_length) )
+    return false;
+
+  a_layout.stride = a_layout.cols + 1;
+  if( (pos + a_layout.cols < a_length) &&
+      (a_file[pos + a_layout.cols] == '\r') )
+    a_layout.stride = a_layout.cols + 2;
+
+  // The last row starts no later than cols bytes before the end
+  return (a_length - pos - a_layout.cols) / a_layout.stride >=
+    (size_t)(a_layout.rows - 1);
+}
+
+/*
+ * Purpose : Checks that rows of a maze map file are all the right length:
+ *         : no line ends early, and each ends where the first one did (or
+ *         : at the end of the file)
+ * Arguments -
+ *   const char* a_file : The file's contents (usually mapped)
+ *   size_t a_length : Length of the file in bytes
+ *   MazeMapLayout& a_layout : Layout read by readMazeMapLayout()
+ *   long a_firstRow : First row to check
+ *   long a_rowCount : Number of rows to check
+ * Returns : true if every row checked is well-formed
+ */
+bool mazeMapRowsValid(const char* a_file, size_t a_length,
+		      MazeMapLayout& a_layout, long a_firstRow, long a_rowCount)
+{
+  long cols = a_layout.cols;
+  long stride = a_layout.stride;
+
+  for(long row = a_firstRow; row < a_firstRow + a_rowCount; row++)
+    {
+      size_t rowPos = a_layout.dataStart + row * stride;
+      const char* rowStart = a_file + rowPos;
+
+      // No line may end early...
+      if(memchr(rowStart, '\n', cols) != NULL)
+	return false;
+      // ...and each must end where the first one did (or at end of file)
+      else if(rowPos + cols < a_length)
+	{
+	  if( (stride == cols + 2) && (rowStart[cols] != '\r') )
+	    return false;
+	  else if(rowStart[stride - 1] != '\n')
+	    return false;
+	}
+    }
+
+  return true;
+}
+
+/*
+ * Purpose : Maps a maze map file into memory and uses its tiles in place.
+ *         : Only well-formed files are accepted: a "rows cols" line, then
+ *         : rows lines of exactly cols tiles, all ending the same way
+ *         : ("\n" or "\r\n"; the last line may have no ending at all).
+ * Arguments -
+ *   MazeMap& a_mazeMap : Reference to MazeMap
+ *   string a_inputFileName : String of input file name
+ * Returns : 0 if the file was mapped, -1 otherwise (the MazeMap is left
+ *         : untouched, so the file can still be read the slow way)
+ */
+int mapMazeMapFile(MazeMap& a_mazeMap, string a_inputFileName)
+{
+  int fd = open(a_inputFileName.c_str(), O_RDONLY);
+  if(fd < 0)
+    return -1;
+
+  struct stat fileStat;
+  if( (fstat(fd, &fileStat) != 0) || (fileStat.st_size == 0) )
+    {
+      close(fd);
+      return -1;
+    }
+
+  size_t length = fileStat.st_size;
+  void* mapping = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+
+  if(mapping == MAP_FAILED)
     return -1;
+
+  const char* file = (const char*)mapping;
+
+  MazeMapLayout layout;
+  bool valid = readMazeMapLayout(file, length, layout) &&
+    (layout.rows * layout.stride <= MAZE_MAP_MAX_TILES) &&
+    mazeMapRowsValid(file, length, layout, 0, layout.rows);
+
+  if( !valid )
+    {
+      munmap(mapping, length);
+      return -1;
+    }
+
+  a_mazeMap.map = (char*)(file + layout.dataStart);
+  a_mazeMap.rows = layout.rows;
+  a_mazeMap.cols = layout.cols;
+  a_mazeMap.stride = layout.stride;
+  a_mazeMap.visited = NULL;
+  a_mazeMap.mapping = mapping;
+  a_mazeMap.mappingLength = length;
+
+  return 0;
 }
 
 /*
@@ -793,25 +1719,45 @@ void copyMazeMap(MazeMap& a_mazeMapSource, MazeMap& a_mazeMapDestination)
 {
   a_mazeMapDestination.rows = a_mazeMapSource.rows;
   a_mazeMapDestination.cols = a_mazeMapSource.cols;
+  a_mazeMapDestination.stride = a_mazeMapSource.cols;
+  a_mazeMapDestination.visited = NULL;
+  a_mazeMapDestination.mapping = NULL;
+  a_mazeMapDestination.mappingLength = 0;
 
   /** ALLOCATE MEMORY FOR MAZE **/
 
-  // Allocate rows
-  a_mazeMapDestination.map = new char*[a_mazeMapDestination.rows];
+  // Allocate all rows as one contiguous (row-major) block
+  a_mazeMapDestination.map =
+    new char[a_mazeMapDestination.rows * a_mazeMapDestination.cols];
 
-  // Allocate columns
-  int row=0, col=0;
-  for(row=0; row < a_mazeMapDestination.rows; row++)
+  // Copy map, row by row (the source may be a mapped file)
+  for(int row = 0; row < a_mazeMapSource.rows; row++)
     {
-      a_mazeMapDestination.map[row] = new char[a_mazeMapDestination.cols];
+      memcpy(&mazeMapCell(a_mazeMapDestination, row, 0),
+	     &mazeMapCell(a_mazeMapSource, row, 0), a_mazeMapSource.cols);
     }
 
-  // Zero out map
-  for(row = 0; row < a_mazeMapDestination.rows; row++)
-    {
-      for(col = 0; col < a_mazeMapDestination.cols; col++)
-	{
-	  a_mazeMapDestination.map[row][col] = a_mazeMapSource.map[row][col];
-	}
-    }
+  scanMazeMap(a_mazeMapDestination);
+}
+
+/*
+ * Purpose : Frees the memory held by a MazeMap
+ * Arguments -
+ *   MazeMap& a_mazeMap : MazeMap to free
+ */
+void destroyMazeMap(MazeMap& a_mazeMap)
+{
+  if(a_mazeMap.mapping != NULL)
+    munmap(a_mazeMap.mapping, a_mazeMap.mappingLength);
+  else
+    delete [] a_mazeMap.map;
+
+  delete [] a_mazeMap.visited;
+  delete [] a_mazeMap.openBits;
+
+  a_mazeMap.map = NULL;
+  a_mazeMap.visited = NULL;
+  a_mazeMap.openBits = NULL;
+  a_mazeMap.mapping = NULL;
+  a_mazeMap.mappingLength = 0;
 }
@@ -1,14 +1,38 @@
 #ifndef H_MazeApp
 #define H_MazeApp
 
+#include <vector>
+
 #include "Move.h"
+#include "PackedPath.h"
+#include "Pool.h"
 #include "Stack.h"
 
 
+//-----------------------------------------------------------------------------
+// Globals
+//-----------------------------------------------------------------------------
+
+/** This indicates very obvious errors, as it states... **/
+const int FLAGRANT_ERROR = -1;
+
+/** These indicate directions, as they state! **/
+const char EAST = 'E';
+const char NORTH = 'N';
+const char WEST = 'W';
+const char SOUTH = 'S';
+
+/** Tiles a maze may have at most, since tiles are indexed with an int **/
+const long long MAZE_MAP_MAX_TILES = 0x7fffffffLL;
+
+
 //-----------------------------------------------------------------------------
 // "Support" structures (meaning, that they help make code pretty)
 //-----------------------------------------------------------------------------
 
+// Declared in MazeSearch.h
+struct MazeSearchOptions;
+
 struct MazeCursor
 {
   Position currPos;
@@ -17,55 +41,159 @@ struct MazeCursor
 
 struct MazeMap
 {
-  char** map;
+  /** Tiles, stored row-major; row r starts at map + r*stride **/
+  char* map;
+
+  /** Flags cells the DFS has been to (rows*cols, row-major), allocated
+      by the DFS when it first needs them **/
+  bool* visited;
 
   int rows;
   int cols;
+
+  /** Bytes from the start of one row to the next (cols, or more when the
+      tiles are read straight out of a mapped file with line endings) **/
+  int stride;
+
+  /** The mapped input file, if map points into it (else NULL) **/
+  void* mapping;
+  size_t mappingLength;
+
+  /** Passability bitmap (bit set for ' ' and 'd'), openWords 64-bit words
+      per row; built by scanMazeMap() when the map is loaded **/
+  unsigned long long* openBits;
+  int openWords;
+
+  /** First entrance and dragon, and the number of dragons, also found by
+      scanMazeMap() **/
+  bool hasEntrance;
+  Position entrancePos;
+  bool hasDragon;
+  Position dragonPos;
+  long dragonCount;
+};
+
+// Where the rows of a text maze map file are
+struct MazeMapLayout
+{
+  long rows;
+  long cols;
+
+  /** Offset of the first tile, and bytes from one row to the next **/
+  size_t dataStart;
+  long stride;
 };
 
 
 //-----------------------------------------------------------------------------
-// Function signatures
+// MazeMap accessors (used everywhere the map is indexed)
 //-----------------------------------------------------------------------------
 
-void displayMazeMap(MazeMap& a_mazeMap);
-void displayMazeMapSolution(MazeMap& a_mazeMap, Stack<Move*>& a_moveStack,
-			    Stack<Move*>& a_backtrackStack);
+// Returns the offset of (row, col) into rows*cols grids (visited, and the
+// per-cell grids kept by the search engines)
+inline int mazeMapIndex(const MazeMap& a_mazeMap, int a_row, int a_col)
+{
+  return a_row * a_mazeMap.cols + a_col;
+}
+
+// Returns a reference to the tile at (row, col)
+inline char& mazeMapCell(MazeMap& a_mazeMap, int a_row, int a_col)
+{
+  return a_mazeMap.map[a_row * a_mazeMap.stride + a_col];
+}
+
+// Returns the tile at a rows*cols grid offset (as made by mazeMapIndex())
+inline char mazeMapCellAt(MazeMap& a_mazeMap, int a_index)
+{
+  return mazeMapCell(a_mazeMap, a_index / a_mazeMap.cols,
+		     a_index % a_mazeMap.cols);
+}
+
+// Returns true if the tile at (row, col) is ' ' or 'd' (no bounds check)
+inline bool mazeMapOpenTile(MazeMap& a_mazeMap, int a_row, int a_col)
+{
+  return (a_mazeMap.openBits[a_row * a_mazeMap.openWords + (a_col >> 6)] >>
+	  (a_col & 63)) & 1;
+}
+
+// Returns true if (row, col) is in bounds and may be moved to
+inline bool mazeMapIsOpen(MazeMap& a_mazeMap, int a_row, int a_col)
+{
+  if( (a_row < 0) || (a_row >= a_mazeMap.rows) ||
+      (a_col < 0) || (a_col >= a_mazeMap.cols) )
+    return false;
+
+  return mazeMapOpenTile(a_mazeMap, a_row, a_col);
+}
+
+
+//-----------------------------------------------------------------------------
+// Function signatures
+//-----------------------------------------------------------------------------
 
-void displaySolutionMoves(Stack<Move*>& a_moveStack);
+int solveMazeFile(string a_inputFileName, MazeSearchOptions& a_options,
+		  ostream& a_out, ostream& a_err);
+int streamMazeFile(string a_inputFileName, long long a_bandRows,
+		   int a_maxSweeps, ostream& a_out, ostream& a_err);
+int convertMazeFile(string a_inputFileName, string a_outputFileName,
+		    bool a_toBinary, ostream& a_out, ostream& a_err);
+int answerMazeQueries(string a_inputFileName, vector<Position>& a_queries,
+		      bool a_rebuildField, ostream& a_out, ostream& a_err);
+bool readByteCount(string a_text, long long& a_bytes);
+
+void displayDragonRoutes(MazeMap& a_mazeMap, ostream& a_out);
+void displayMazeMap(MazeMap& a_mazeMap, ostream& a_out);
+void displayMazeMapSolution(MazeMap& a_mazeMap, PackedPath& a_solution,
+			    Stack<Move*>& a_backtrackStack, ostream& a_out);
+
+void displaySolutionMoves(PackedPath& a_solution, ostream& a_out);
+void packMoveStack(Position a_entrancePos, Stack<Move*>& a_moveStack,
+		   PackedPath& a_solution);
 bool findMazeMapEntrance(Position& a_entrancePos, MazeMap& a_mazeMap);
+bool findMazeMapDragon(Position& a_dragonPos, MazeMap& a_mazeMap);
 int readMazeMapFile(MazeMap& a_mazeMap, string a_inputFileName);
+int mapMazeMapFile(MazeMap& a_mazeMap, string a_inputFileName);
+bool readMazeMapLayout(const char* a_file, size_t a_length,
+		       MazeMapLayout& a_layout);
+bool mazeMapRowsValid(const char* a_file, size_t a_length,
+		      MazeMapLayout& a_layout, long a_firstRow,
+		      long a_rowCount);
 void copyMazeMap(MazeMap& a_mazeMapSource, MazeMap& a_mazeMapDestination);
+void destroyMazeMap(MazeMap& a_mazeMap);
+
+bool solveMazeDFS(MazeMap& a_mazeMap, Position a_entrancePos,
+		  Stack<Move*>& a_moveStack, Stack<Move*>& a_backtrackStack,
+		  Pool<Move>& a_movePool);
 
 bool dragonIsHere(MazeMap& a_mazeMap, MazeCursor& a_mazeCursor);
 
 bool canMove(MazeMap& a_mazeMap, MazeCursor& a_mazeCursor,
-	     Stack<Move*>& a_moveStack,
-	     Stack<Move*>& a_feasibleMoveStack);
+	     Stack<Move*>& a_feasibleMoveStack, Pool<Move>& a_movePool);
 
-void addMoveEast(MazeCursor& a_mazeCursor, Stack<Move*>& a_feasibleMoveStack);
-bool canMoveEast(MazeMap& a_mazeMap, MazeCursor& a_mazeCursor,
-		 Stack<Move*>& a_moveStack);
+void addMoveEast(MazeCursor& a_mazeCursor, Stack<Move*>& a_feasibleMoveStack,
+                 Pool<Move>& a_movePool);
+bool canMoveEast(MazeMap& a_mazeMap, MazeCursor& a_mazeCursor);
 bool dragonIsEast(MazeMap& a_mazeMap, MazeCursor& a_mazeCursor);
 
-void addMoveNorth(MazeCursor& a_mazeCursor, Stack<Move*>& a_feasibleMoveStack);
-bool canMoveNorth(MazeMap& a_mazeMap, MazeCursor& a_mazeCursor,
-		  Stack<Move*>& a_moveStack);
+void addMoveNorth(MazeCursor& a_mazeCursor, Stack<Move*>& a_feasibleMoveStack,
+                  Pool<Move>& a_movePool);
+bool canMoveNorth(MazeMap& a_mazeMap, MazeCursor& a_mazeCursor);
 bool dragonIsNorth(MazeMap& a_mazeMap, MazeCursor& a_mazeCursor);
 
-void addMoveWest(MazeCursor& a_mazeCursor, Stack<Move*>& a_feasibleMoveStack);
-bool canMoveWest(MazeMap& a_mazeMap, MazeCursor& a_mazeCursor,
-		 Stack<Move*>& a_moveStack);
+void addMoveWest(MazeCursor& a_mazeCursor, Stack<Move*>& a_feasibleMoveStack,
+                 Pool<Move>& a_movePool);
+bool canMoveWest(MazeMap& a_mazeMap, MazeCursor& a_mazeCursor);
 bool dragonIsWest(MazeMap& a_mazeMap, MazeCursor& a_mazeCursor);
 
-void addMoveSouth(MazeCursor& a_mazeCursor, Stack<Move*>& a_feasibleMoveStack);
-bool canMoveSouth(MazeMap& a_mazeMap, MazeCursor& a_mazeCursor,
-		  Stack<Move*>& a_moveStack);
+void addMoveSouth(MazeCursor& a_mazeCursor, Stack<Move*>& a_feasibleMoveStack,
+                  Pool<Move>& a_movePool);
+bool canMoveSouth(MazeMap& a_mazeMap, MazeCursor& a_mazeCursor);
 bool dragonIsSouth(MazeMap& a_mazeMap, MazeCursor& a_mazeCursor);
 
-bool moveAlreadyMade(int a_xPos, int a_yPos, Stack<Move*>& a_moveStack);
-bool makeMove(MazeCursor& a_mazeCursor, Stack<Move*>& a_feasibleMoveStack,
-	      Stack<Move*>& a_moveStack);
+bool moveAlreadyMade(MazeMap& a_mazeMap, int a_xPos, int a_yPos);
+bool makeMove(MazeMap& a_mazeMap, MazeCursor& a_mazeCursor,
+	      Stack<Move*>& a_feasibleMoveStack, Stack<Move*>& a_moveStack,
+	      Pool<Move>& a_movePool);
 
 bool backtrack(Stack<Move*>& a_feasibleMoveStack, Stack<Move*>& a_moveStack,
 	       Stack<Move*>& a_backtrackStack);
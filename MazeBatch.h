@@ -0,0 +1,33 @@
+/* ------------------------------------------------------------------------- *
+ *
+ * Filename : MazeBatch.h
+ * Version  : 1.0
+ *
+ * Purpose  : Declares batch mode, which solves many maze files in one run
+ *          : on a pool of threads.  Each maze's output is written in the
+ *          : order the files were given.
+ *
+ * ------------------------------------------------------------------------- */
+
+#ifndef H_MazeBatch
+#define H_MazeBatch
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "MazeSearch.h"
+
+using namespace std;
+
+
+//-----------------------------------------------------------------------------
+// Function prototypes
+//-----------------------------------------------------------------------------
+
+bool collectBatchFiles(string a_argument, vector<string>& a_fileNames);
+
+void runMazeBatch(vector<string>& a_fileNames, MazeSearchOptions& a_options,
+		  int a_threadCount, ostream& a_out);
+
+#endif
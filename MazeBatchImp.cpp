@@ -0,0 +1,173 @@
+/* ------------------------------------------------------------------------- *
+ *
+ * Filename : MazeBatchImp.cpp
+ * Version  : 1.0
+ *
+ * Purpose  : Implementation of batch mode
+ *
+ * ------------------------------------------------------------------------- */
+
+#include <algorithm>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include "MazeBatch.h"
+#include "ThreadPool.h"
+
+
+//-----------------------------------------------------------------------------
+// "Support" structures
+//-----------------------------------------------------------------------------
+
+// Name: MazeBatchJob
+// Purpose: Everything the batch tasks share.  Each task solves one maze
+//        : into its own buffers; the buffers are written out in file
+//        : order as soon as every earlier maze is done.
+struct MazeBatchJob
+{
+  vector<string>* fileNames;
+  MazeSearchOptions* options;
+  ostream* out;
+
+  /** Output of each maze, and whether it is ready **/
+  vector<string> outputs;
+  vector<string> errors;
+  vector<bool> finished;
+
+  /** Next maze to write out, and the lock guarding all of the above **/
+  unsigned int nextToWrite;
+  mutex lock;
+};
+
+
+//-----------------------------------------------------------------------------
+// Helper functions
+//-----------------------------------------------------------------------------
+
+/*
+ * Purpose : Solves one maze of a batch (run on the thread pool)
+ * Arguments -
+ *   int a_index : Index of the maze file
+ *   void* a_context : The MazeBatchJob
+ */
+static void solveBatchMaze(int a_index, void* a_context)
+{
+  MazeBatchJob* job = (MazeBatchJob*)a_context;
+  ostringstream out;
+  ostringstream err;
+
+  solveMazeFile((*job->fileNames)[a_index], *job->options, out, err);
+
+  unique_lock<mutex> guard(job->lock);
+  job->outputs[a_index] = out.str();
+  job->errors[a_index] = err.str();
+  job->finished[a_index] = true;
+
+  while( (job->nextToWrite < job->finished.size()) &&
+	 job->finished[job->nextToWrite] )
+    {
+      unsigned int i = job->nextToWrite++;
+
+      *job->out << job->outputs[i];
+      cerr << job->errors[i];
+      job->out->flush();
+
+      // Free the buffers now that they're written
+      string().swap(job->outputs[i]);
+      string().swap(job->errors[i]);
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// Program functions
+//-----------------------------------------------------------------------------
+
+/*
+ * Purpose : Expands one batch argument into maze file names.  A directory
+ *         : gives the regular files in it (sorted by name), "@name" gives
+ *         : the paths listed one per line in the manifest "name", and
+ *         : anything else is taken as a maze file name.
+ * Arguments -
+ *   string a_argument : The command line argument
+ *   vector<string>& a_fileNames : Receives the file names
+ * Returns : false if the directory or manifest cannot be read
+ */
+bool collectBatchFiles(string a_argument, vector<string>& a_fileNames)
+{
+  if( (a_argument.size() > 1) && (a_argument[0] == '@') )
+    {
+      ifstream manifest(a_argument.substr(1).c_str());
+      if(!manifest)
+	return false;
+
+      string line;
+      while( getline(manifest, line) )
+	{
+	  if( (line.size() > 0) && (line[line.size() - 1] == '\r') )
+	    line.erase(line.size() - 1);
+	  if(line.size() > 0)
+	    a_fileNames.push_back(line);
+	}
+      return true;
+    }
+
+  struct stat info;
+  if( (stat(a_argument.c_str(), &info) == 0) && S_ISDIR(info.st_mode) )
+    {
+      DIR* dir = opendir(a_argument.c_str());
+      if(dir == NULL)
+	return false;
+
+      vector<string> entries;
+      struct dirent* entry;
+      while( (entry = readdir(dir)) != NULL )
+	{
+	  string path = a_argument + "/" + entry->d_name;
+	  if( (stat(path.c_str(), &info) == 0) && S_ISREG(info.st_mode) )
+	    entries.push_back(path);
+	}
+      closedir(dir);
+
+      sort(entries.begin(), entries.end());
+      a_fileNames.insert(a_fileNames.end(), entries.begin(), entries.end());
+      return true;
+    }
+
+  a_fileNames.push_back(a_argument);
+  return true;
+}
+
+/*
+ * Purpose : Solves every maze file of a batch on a pool of threads and
+ *         : writes each maze's output, in file order, to a stream
+ * Arguments -
+ *   vector<string>& a_fileNames : Maze file names
+ *   MazeSearchOptions& a_options : How to search
+ *   int a_threadCount : Threads to use (0 means one per core)
+ *   ostream& a_out : Stream to write to (errors go to cerr)
+ */
+void runMazeBatch(vector<string>& a_fileNames, MazeSearchOptions& a_options,
+		  int a_threadCount, ostream& a_out)
+{
+  MazeBatchJob job;
+  job.fileNames = &a_fileNames;
+  job.options = &a_options;
+  job.out = &a_out;
+  job.outputs.resize(a_fileNames.size());
+  job.errors.resize(a_fileNames.size());
+  job.finished.resize(a_fileNames.size(), false);
+  job.nextToWrite = 0;
+
+  // No point starting more threads than there are mazes
+  if(a_threadCount <= 0)
+    a_threadCount = thread::hardware_concurrency();
+  if(a_threadCount > (int)a_fileNames.size())
+    a_threadCount = (int)a_fileNames.size();
+
+  ThreadPool pool(a_threadCount);
+  pool.runTasks((int)a_fileNames.size(), solveBatchMaze, &job);
+}
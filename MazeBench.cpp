@@ -0,0 +1,433 @@
+/* ------------------------------------------------------------------------- *
+ *
+ * Filename : MazeBench.cpp
+ * Version  : 1.0
+ *
+ * Purpose  : This program benchmarks the maze solvers.  It generates mazes
+ *          : of each requested style and size, solves each with every
+ *          : requested mode, and prints one JSON object per solve (wall
+ *          : time, cells expanded, peak memory and allocations), so runs
+ *          : from different versions can be compared line by line.  It
+ *          : fails if a solver that should find a shortest path finds one
+ *          : longer or shorter than breadth-first search does.
+ *
+ * ------------------------------------------------------------------------- */
+
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/resource.h>
+
+#include "MazeApp.h"
+#include "MazeBinary.h"
+#include "MazeField.h"
+#include "MazeGen.h"
+#include "MazeGraph.h"
+#include "MazeJump.h"
+#include "MazeScan.h"
+#include "MazeSearch.h"
+#include "MazeStream.h"
+
+using namespace std;
+
+
+//-----------------------------------------------------------------------------
+// "Support" structures (meaning, that they help make code pretty)
+//-----------------------------------------------------------------------------
+
+// Name: BenchOutcome
+// Purpose: Stores what one solve found
+struct BenchOutcome
+{
+  bool foundDragon;
+
+  /** Moves on the path found (-1 if none) **/
+  long long length;
+
+  /** Cells expanded (-1 if the mode doesn't count them) **/
+  long long expanded;
+};
+
+
+//-----------------------------------------------------------------------------
+// Globals
+//-----------------------------------------------------------------------------
+
+/** Every solver mode, in the order they are run by default **/
+const char* BENCH_MODES[] = { "dfs", "bfs", "astar", "idastar", "jps",
+			      "bidirectional", "parallel-bfs", "junctions",
+			      "field", "stream" };
+const int BENCH_MODE_COUNT = 10;
+
+/** Allocations made with new, counted so each solve can report its own **/
+atomic<long long> allocationCount(0);
+atomic<long long> allocationBytes(0);
+
+
+//-----------------------------------------------------------------------------
+// Allocation counting
+//-----------------------------------------------------------------------------
+
+void* operator new(size_t a_size)
+{
+  allocationCount++;
+  allocationBytes += a_size;
+
+  void* block = malloc((a_size > 0) ? a_size : 1);
+  if(block == NULL)
+    throw bad_alloc();
+
+  return block;
+}
+
+void* operator new[](size_t a_size)
+{
+  return operator new(a_size);
+}
+
+void operator delete(void* a_block) noexcept
+{
+  free(a_block);
+}
+
+void operator delete[](void* a_block) noexcept
+{
+  free(a_block);
+}
+
+void operator delete(void* a_block, size_t) noexcept
+{
+  free(a_block);
+}
+
+void operator delete[](void* a_block, size_t) noexcept
+{
+  free(a_block);
+}
+
+
+//-----------------------------------------------------------------------------
+// Helper functions
+//-----------------------------------------------------------------------------
+
+/*
+ * Purpose : Splits a comma-separated list
+ * Arguments -
+ *   string a_list : The list
+ *   vector<string>& a_items : Receives the items
+ */
+static void splitList(string a_list, vector<string>& a_items)
+{
+  a_items.clear();
+
+  istringstream listStream(a_list);
+  string item;
+  while(getline(listStream, item, ','))
+    {
+      if(item.length() > 0)
+	a_items.push_back(item);
+    }
+}
+
+/*
+ * Purpose : Checks that a solver mode name is known
+ * Arguments -
+ *   string a_mode : Name of the mode
+ * Returns : true if it is one of BENCH_MODES
+ */
+static bool knownMode(string a_mode)
+{
+  for(int i = 0; i < BENCH_MODE_COUNT; i++)
+    {
+      if(a_mode == BENCH_MODES[i])
+	return true;
+    }
+
+  return false;
+}
+
+/*
+ * Purpose : Starts measuring peak memory afresh (Linux resets the
+ *         : process's high-water mark when "5" is written to clear_refs)
+ */
+static void resetPeakMemory()
+{
+  ofstream clearRefs("/proc/self/clear_refs");
+  if(clearRefs)
+    clearRefs << "5" << endl;
+}
+
+/*
+ * Purpose : Reads the process's peak memory use since resetPeakMemory()
+ * Returns : Peak resident set size in kilobytes (since the program
+ *         : started, where it can't be reset)
+ */
+static long readPeakMemory()
+{
+  ifstream status("/proc/self/status");
+  string line;
+
+  while(getline(status, line))
+    {
+      if(line.compare(0, 6, "VmHWM:") == 0)
+	return atol(line.c_str() + 6);
+    }
+
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss;
+}
+
+/*
+ * Purpose : Solves a maze with one of the solver modes
+ * Arguments -
+ *   string a_mode : Name of the mode
+ *   MazeMap& a_mazeMap : The maze (a fresh copy for each solve)
+ *   string a_binaryFileName : The same maze in a binary file (for stream)
+ *   int a_threadCount : Threads for parallel-bfs (0 means one per core)
+ * Returns : What the solve found
+ */
+static BenchOutcome runMode(string a_mode, MazeMap& a_mazeMap,
+			    string a_binaryFileName, int a_threadCount)
+{
+  BenchOutcome outcome;
+  outcome.expanded = -1;
+
+  Position entrancePos;
+  findMazeMapEntrance(entrancePos, a_mazeMap);
+
+  if(a_mode == "dfs")
+    {
+      Pool<Move> movePool;
+      Stack<Move*> moveStack;
+      Stack<Move*> backtrackStack;
+      PackedPath solution;
+
+      outcome.foundDragon = solveMazeDFS(a_mazeMap, entrancePos, moveStack,
+					 backtrackStack, movePool);
+      if(outcome.foundDragon)
+	packMoveStack(entrancePos, moveStack, solution);
+      outcome.length = solution.getLength();
+    }
+  else if(a_mode == "field")
+    {
+      DistanceField field;
+      PackedPath path;
+
+      buildDistanceField(a_mazeMap, field);
+      outcome.foundDragon = queryDistanceField(field, entrancePos, path);
+      outcome.length = path.getLength();
+    }
+  else if(a_mode == "stream")
+    {
+      MazeStreamResult result;
+
+      solveMazeStream(a_binaryFileName, 0, INT_MAX, result);
+      outcome.foundDragon = result.foundDragon;
+      outcome.length = result.length;
+    }
+  else
+    {
+      MazeSearchResult result;
+
+      vector<Position> dragons;
+      listMazeMapTiles(a_mazeMap, 'd', dragons);
+
+      if(a_mode == "bfs")
+	result = solveMazeBFS(a_mazeMap, entrancePos);
+      else if(a_mode == "astar")
+	result = solveMazeAStar(a_mazeMap, entrancePos, dragons,
+				manhattanHeuristic);
+      else if(a_mode == "idastar")
+	{
+	  bool hitMemoryLimit;
+	  result = solveMazeIDAStar(a_mazeMap, entrancePos, dragons,
+				    manhattanHeuristic, 0, hitMemoryLimit);
+	}
+      else if(a_mode == "jps")
+	result = solveMazeJumpPoints(a_mazeMap, entrancePos, dragons,
+				     manhattanHeuristic);
+      else if(a_mode == "bidirectional")
+	result = solveMazeBidirectional(a_mazeMap, entrancePos, dragons);
+      else if(a_mode == "parallel-bfs")
+	result = solveMazeParallelBFS(a_mazeMap, entrancePos, a_threadCount);
+      else
+	result = solveMazeJunctions(a_mazeMap, entrancePos);
+
+      outcome.foundDragon = result.foundDragon;
+      outcome.length = result.path.getLength();
+      outcome.expanded = result.expanded;
+    }
+
+  if( !(outcome.foundDragon) )
+    outcome.length = -1;
+
+  return outcome;
+}
+
+
+//-----------------------------------------------------------------------------
+// Main function
+//-----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+  /** READ IN COMMAND LINE ARGUMENTS **/
+
+  int rows = 501;
+  int cols = 0; // same as rows
+  int repeat = 1;
+  unsigned int seed = 1;
+  int threadCount = 0;
+  string label = "unknown";
+  vector<string> styles;
+  vector<string> modes;
+  bool validArgs = true;
+
+  for(int i = 1; i < argc; i++)
+    {
+      string arg = argv[i];
+
+      if(arg.compare(0, 7, "--size=") == 0)
+	rows = atoi(arg.substr(7).c_str());
+      else if(arg.compare(0, 7, "--cols=") == 0)
+	cols = atoi(arg.substr(7).c_str());
+      else if(arg.compare(0, 9, "--styles=") == 0)
+	splitList(arg.substr(9), styles);
+      else if(arg.compare(0, 8, "--modes=") == 0)
+	splitList(arg.substr(8), modes);
+      else if(arg.compare(0, 9, "--repeat=") == 0)
+	repeat = atoi(arg.substr(9).c_str());
+      else if(arg.compare(0, 7, "--seed=") == 0)
+	seed = strtoul(arg.substr(7).c_str(), NULL, 10);
+      else if(arg.compare(0, 10, "--threads=") == 0)
+	threadCount = atoi(arg.substr(10).c_str());
+      else if(arg.compare(0, 8, "--label=") == 0)
+	label = arg.substr(8);
+      else
+	validArgs = false;
+    }
+
+  if(cols == 0)
+    cols = rows;
+
+  // No list (or an empty one) means all of them
+  if(styles.empty())
+    splitList("backtracker,open,spiral,unsolvable,dragons", styles);
+  if(modes.empty())
+    modes.assign(BENCH_MODES, BENCH_MODES + BENCH_MODE_COUNT);
+
+  MazeStyle style;
+  for(unsigned int i = 0; i < styles.size(); i++)
+    validArgs = validArgs && findMazeStyle(styles[i], style);
+  for(unsigned int i = 0; i < modes.size(); i++)
+    validArgs = validArgs && knownMode(modes[i]);
+
+  if( !validArgs || (rows < MAZE_GEN_MIN_SIZE) ||
+      (cols < MAZE_GEN_MIN_SIZE) || (repeat < 1) )
+    {
+      cerr << "Invalid argument form." << endl;
+      cerr << "Use form: 'MazeBench [--size=rows] [--cols=n] "
+	   << "[--styles=a,b,...] [--modes=a,b,...]" << endl
+	   << "                     [--repeat=n] [--seed=n] [--threads=n] "
+	   << "[--label=text]'" << endl;
+      cerr << "Styles: backtracker, open, spiral, unsolvable, dragons"
+	   << endl;
+      cerr << "Modes: dfs, bfs, astar, idastar, jps, bidirectional, "
+	   << "parallel-bfs, junctions, field, stream" << endl;
+      exit(0);
+    }
+
+  /** GENERATE AND SOLVE **/
+
+  cout << fixed << setprecision(3);
+
+  int mismatches = 0;
+
+  for(unsigned int s = 0; s < styles.size(); s++)
+    {
+      findMazeStyle(styles[s], style);
+
+      MazeMap generated;
+      generateMaze(style, rows, cols, seed, generated);
+
+      // The streaming solver reads its maze from a file
+      char binaryFileName[] = "/tmp/MazeBenchXXXXXX";
+      int fd = mkstemp(binaryFileName);
+      if(fd >= 0)
+	{
+	  close(fd);
+	  writeMazeBinaryFile(generated, binaryFileName);
+	}
+
+      // Every mode but dfs must find a path as short as this one
+      MazeMap checkMap;
+      copyMazeMap(generated, checkMap);
+      long long shortest = runMode("bfs", checkMap, binaryFileName,
+				   threadCount).length;
+      destroyMazeMap(checkMap);
+
+      for(unsigned int m = 0; m < modes.size(); m++)
+	{
+	  for(int run = 0; run < repeat; run++)
+	    {
+	      MazeMap mazeMap;
+	      copyMazeMap(generated, mazeMap);
+
+	      resetPeakMemory();
+	      long long allocations = allocationCount;
+	      long long allocated = allocationBytes;
+	      chrono::steady_clock::time_point start =
+		chrono::steady_clock::now();
+
+	      BenchOutcome outcome = runMode(modes[m], mazeMap, binaryFileName,
+					     threadCount);
+
+	      double wallMs = chrono::duration<double, milli>
+		(chrono::steady_clock::now() - start).count();
+	      allocations = allocationCount - allocations;
+	      allocated = allocationBytes - allocated;
+	      long peakMemory = readPeakMemory();
+
+	      destroyMazeMap(mazeMap);
+
+	      cout << "{\"label\": \"" << label << "\", \"style\": \""
+		   << styles[s] << "\", \"rows\": " << rows << ", \"cols\": "
+		   << cols << ", \"seed\": " << seed << ", \"mode\": \""
+		   << modes[m] << "\", \"run\": " << run << ", \"found\": "
+		   << (outcome.foundDragon ? "true" : "false")
+		   << ", \"length\": " << outcome.length << ", \"expanded\": ";
+	      if(outcome.expanded >= 0)
+		cout << outcome.expanded;
+	      else
+		cout << "null";
+	      cout << ", \"wall_ms\": " << wallMs << ", \"peak_rss_kb\": "
+		   << peakMemory << ", \"allocations\": " << allocations
+		   << ", \"allocated_bytes\": " << allocated << "}" << endl;
+
+	      if( (modes[m] != "dfs") && (outcome.length != shortest) )
+		{
+		  cerr << "Mode " << modes[m] << " found a path of "
+		       << outcome.length << " moves in the " << styles[s]
+		       << " maze, but bfs found one of " << shortest << "."
+		       << endl;
+		  mismatches++;
+		}
+	    }
+	}
+
+      unlink(binaryFileName);
+      destroyMazeMap(generated);
+    }
+
+  return (mismatches > 0) ? 1 : 0;
+}
@@ -0,0 +1,116 @@
+/* ------------------------------------------------------------------------- *
+ *
+ * Filename : MazeBinary.h
+ * Version  : 1.0
+ *
+ * Purpose  : Declares the binary maze format and the conversions between
+ *          : it and the text format.  A binary maze file is:
+ *          :
+ *          :   - a 64-byte MazeBinaryHeader,
+ *          :   - the landmarks: a (row, col) pair of 32-bit numbers for
+ *          :     each entrance, then for each dragon, in row-major order,
+ *          :   - from the next multiple of 64 bytes, the wall bitmap: one
+ *          :     bit per tile, set for walls, with each row padded to a
+ *          :     whole number of 64-bit words (the same layout as a
+ *          :     MazeMap's passability bitmap).
+ *          :
+ *          : Numbers are stored in the machine's own byte order.  Tiles
+ *          : other than ' ', 'e' and 'd' are stored as walls.
+ *
+ * ------------------------------------------------------------------------- */
+
+#ifndef H_MazeBinary
+#define H_MazeBinary
+
+#include <string>
+
+#include "MazeApp.h"
+
+using namespace std;
+
+
+//-----------------------------------------------------------------------------
+// "Support" structures (meaning, that they help make code pretty)
+//-----------------------------------------------------------------------------
+
+// Name: MazeBinaryHeader
+// Purpose: The fixed-size start of a binary maze file
+struct MazeBinaryHeader
+{
+  /** MAZE_BINARY_TAG, then the format version **/
+  char tag[8];
+  unsigned int version;
+
+  unsigned int rows;
+  unsigned int cols;
+
+  /** 64-bit words per row of the wall bitmap **/
+  unsigned int wordsPerRow;
+
+  unsigned int entranceCount;
+  unsigned int dragonCount;
+
+  /** Offsets of the landmarks and the wall bitmap from the file start **/
+  unsigned long long landmarkOffset;
+  unsigned long long bitmapOffset;
+
+  /** Pads the header to 64 bytes (written as zeroes) **/
+  char reserved[16];
+};
+
+
+//-----------------------------------------------------------------------------
+// Globals
+//-----------------------------------------------------------------------------
+
+/** Tag at the start of every binary maze file **/
+const char MAZE_BINARY_TAG[8] = { 'M', 'A', 'Z', 'E', 'B', 'I', 'N', 0 };
+
+/** Version of the format written **/
+const unsigned int MAZE_BINARY_VERSION = 1;
+
+/** Alignment of the wall bitmap in the file **/
+const int MAZE_BINARY_ALIGN = 64;
+
+
+//-----------------------------------------------------------------------------
+// Function signatures
+//-----------------------------------------------------------------------------
+
+bool mazeBinaryHeaderValid(const char* a_file, size_t a_length);
+  /* Purpose : Checks that a mapped file starts with a usable binary maze
+   *         : header, and that everything it points to is inside the file
+   * Arguments -
+   *   const char* a_file : The mapped file
+   *   size_t a_length : Length of the file in bytes
+   * Returns : true if the header is usable
+   */
+
+int readMazeBinaryFile(MazeMap& a_mazeMap, string a_inputFileName);
+  /* Purpose : Loads a binary maze file, building the tiles and passability
+   *         : bitmap straight from the mapped wall bitmap
+   * Arguments -
+   *   MazeMap& a_mazeMap : Reference to MazeMap
+   *   string a_inputFileName : String of input file name
+   * Returns : 0 if the file was loaded, -1 if it cannot be read or is not
+   *         : a binary maze file (the MazeMap is left untouched)
+   */
+
+int writeMazeBinaryFile(MazeMap& a_mazeMap, string a_outputFileName);
+  /* Purpose : Writes a maze in the binary format
+   * Arguments -
+   *   MazeMap& a_mazeMap : Reference to a scanned MazeMap
+   *   string a_outputFileName : String of output file name
+   * Returns : 0 if the file was written, -1 otherwise
+   */
+
+int writeMazeTextFile(MazeMap& a_mazeMap, string a_outputFileName);
+  /* Purpose : Writes a maze in the text format ("rows cols", then the
+   *         : rows of tiles)
+   * Arguments -
+   *   MazeMap& a_mazeMap : Reference to a MazeMap
+   *   string a_outputFileName : String of output file name
+   * Returns : 0 if the file was written, -1 otherwise
+   */
+
+#endif
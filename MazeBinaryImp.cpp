@@ -0,0 +1,338 @@
+/* ------------------------------------------------------------------------- *
+ *
+ * Filename : MazeBinaryImp.cpp
+ * Version  : 1.0
+ *
+ * Purpose  : Implementation of the binary maze format and the conversions
+ *          : between it and the text format
+ *
+ * ------------------------------------------------------------------------- */
+
+#include <climits>
+#include <fstream>
+#include <vector>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "MazeBinary.h"
+#include "MazeScan.h"
+
+
+//-----------------------------------------------------------------------------
+// "Support" structures
+//-----------------------------------------------------------------------------
+
+// Name: TileExpansion
+// Purpose: The eight tiles (' ' for open, '*' for not) spelled out by each
+//        : byte of a passability bitmap, lowest bit first
+struct TileExpansion
+{
+  char tiles[256][8];
+
+  TileExpansion()
+  {
+    for(int byte = 0; byte < 256; byte++)
+      for(int bit = 0; bit < 8; bit++)
+	tiles[byte][bit] = ((byte >> bit) & 1) ? ' ' : '*';
+  }
+};
+
+
+//-----------------------------------------------------------------------------
+// Function definitions
+//-----------------------------------------------------------------------------
+
+/*
+ * Purpose : Checks that a mapped file starts with a usable binary maze
+ *         : header, and that everything it points to is inside the file
+ * Arguments -
+ *   const char* a_file : The mapped file
+ *   size_t a_length : Length of the file in bytes
+ * Returns : true if the header is usable
+ */
+bool mazeBinaryHeaderValid(const char* a_file, size_t a_length)
+{
+  if(a_length < sizeof(MazeBinaryHeader))
+    return false;
+
+  const MazeBinaryHeader* header = (const MazeBinaryHeader*)a_file;
+
+  if( (memcmp(header->tag, MAZE_BINARY_TAG, sizeof(header->tag)) != 0) ||
+      (header->version != MAZE_BINARY_VERSION) )
+    return false;
+
+  unsigned long long rows = header->rows;
+  unsigned long long cols = header->cols;
+  unsigned long long landmarks =
+    (unsigned long long)header->entranceCount + header->dragonCount;
+
+  if( (rows < 1) || (cols < 1) || (rows > INT_MAX) || (cols > INT_MAX) ||
+      (header->wordsPerRow != (cols + 63) / 64) || (landmarks > rows * cols) )
+    return false;
+
+  // Landmarks after the header, bitmap after the landmarks, all in the
+  // file (compared as differences, so a huge offset can't wrap around)
+  return (header->landmarkOffset >= sizeof(MazeBinaryHeader)) &&
+    (header->landmarkOffset % sizeof(unsigned int) == 0) &&
+    (header->bitmapOffset % sizeof(unsigned long long) == 0) &&
+    (header->landmarkOffset <= header->bitmapOffset) &&
+    (landmarks * 2 * sizeof(unsigned int) <=
+     header->bitmapOffset - header->landmarkOffset) &&
+    (header->bitmapOffset <= a_length) &&
+    (rows * header->wordsPerRow * sizeof(unsigned long long) <=
+     a_length - header->bitmapOffset);
+}
+
+/*
+ * Purpose : Loads a binary maze file.  The passability bitmap is the wall
+ *         : bitmap inverted, a word at a time, and the tiles are spelled
+ *         : out from it eight at a time.
+ * Arguments -
+ *   MazeMap& a_mazeMap : Reference to MazeMap
+ *   string a_inputFileName : String of input file name
+ * Returns : 0 if the file was loaded, -1 if it cannot be read or is not a
+ *         : binary maze file (the MazeMap is left untouched)
+ */
+int readMazeBinaryFile(MazeMap& a_mazeMap, string a_inputFileName)
+{
+  int fd = open(a_inputFileName.c_str(), O_RDONLY);
+  if(fd < 0)
+    return -1;
+
+  struct stat fileStat;
+  if( (fstat(fd, &fileStat) != 0) ||
+      (fileStat.st_size < (off_t)sizeof(MazeBinaryHeader)) )
+    {
+      close(fd);
+      return -1;
+    }
+
+  size_t length = fileStat.st_size;
+  void* mapping = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+
+  if(mapping == MAP_FAILED)
+    return -1;
+
+  const char* file = (const char*)mapping;
+  const MazeBinaryHeader* header = (const MazeBinaryHeader*)file;
+
+  // Only maps small enough to index with an int are loaded whole
+  if( !(mazeBinaryHeaderValid(file, length)) ||
+      ((unsigned long long)header->rows * header->cols > INT_MAX) )
+    {
+      munmap(mapping, length);
+      return -1;
+    }
+
+  int rows = header->rows;
+  int cols = header->cols;
+  int words = header->wordsPerRow;
+  int entranceCount = header->entranceCount;
+  int landmarkCount = entranceCount + header->dragonCount;
+
+  const unsigned int* landmarks =
+    (const unsigned int*)(file + header->landmarkOffset);
+  const unsigned long long* walls =
+    (const unsigned long long*)(file + header->bitmapOffset);
+
+  for(int i = 0; i < landmarkCount; i++)
+    {
+      if( (landmarks[2 * i] >= (unsigned int)rows) ||
+	  (landmarks[2 * i + 1] >= (unsigned int)cols) )
+	{
+	  munmap(mapping, length);
+	  return -1;
+	}
+    }
+
+  a_mazeMap.rows = rows;
+  a_mazeMap.cols = cols;
+  a_mazeMap.stride = cols;
+  a_mazeMap.map = new char[(long)rows * cols];
+  a_mazeMap.visited = NULL;
+  a_mazeMap.mapping = NULL;
+  a_mazeMap.mappingLength = 0;
+  a_mazeMap.openWords = words;
+  a_mazeMap.openBits = new unsigned long long[(long)rows * words];
+
+  static const TileExpansion expansion;
+
+  // Bits past the last column are never open
+  unsigned long long lastWordMask = ~0ULL;
+  if(cols % 64 != 0)
+    lastWordMask = (1ULL << (cols % 64)) - 1;
+
+  for(int row = 0; row < rows; row++)
+    {
+      const unsigned long long* rowWalls = walls + (long)row * words;
+      unsigned long long* rowOpen = a_mazeMap.openBits + (long)row * words;
+      char* tiles = &mazeMapCell(a_mazeMap, row, 0);
+
+      for(int w = 0; w < words; w++)
+	{
+	  rowOpen[w] = ~rowWalls[w];
+	  if(w == words - 1)
+	    rowOpen[w] &= lastWordMask;
+
+	  int first = w * 64;
+	  int count = (cols - first < 64) ? cols - first : 64;
+
+	  int i = 0;
+	  for( ; i + 8 <= count; i += 8)
+	    memcpy(tiles + first + i,
+		   expansion.tiles[(rowOpen[w] >> i) & 0xff], 8);
+	  for( ; i < count; i++)
+	    tiles[first + i] = ((rowOpen[w] >> i) & 1) ? ' ' : '*';
+	}
+    }
+
+  // Entrances can't be moved to; dragons can.  Walking the landmarks
+  // backwards leaves the first of each recorded, as the text loader does.
+  a_mazeMap.hasEntrance = (entranceCount > 0);
+  a_mazeMap.hasDragon = (landmarkCount > entranceCount);
+  a_mazeMap.dragonCount = landmarkCount - entranceCount;
+
+  for(int i = landmarkCount - 1; i >= 0; i--)
+    {
+      int row = landmarks[2 * i];
+      int col = landmarks[2 * i + 1];
+      unsigned long long& word =
+	a_mazeMap.openBits[(long)row * words + (col >> 6)];
+
+      if(i < entranceCount)
+	{
+	  mazeMapCell(a_mazeMap, row, col) = 'e';
+	  word &= ~(1ULL << (col & 63));
+	  a_mazeMap.entrancePos.x = row;
+	  a_mazeMap.entrancePos.y = col;
+	}
+      else
+	{
+	  mazeMapCell(a_mazeMap, row, col) = 'd';
+	  word |= 1ULL << (col & 63);
+	  a_mazeMap.dragonPos.x = row;
+	  a_mazeMap.dragonPos.y = col;
+	}
+    }
+
+  munmap(mapping, length);
+
+  return 0;
+}
+
+/*
+ * Purpose : Writes a maze in the binary format
+ * Arguments -
+ *   MazeMap& a_mazeMap : Reference to a scanned MazeMap
+ *   string a_outputFileName : String of output file name
+ * Returns : 0 if the file was written, -1 otherwise
+ */
+int writeMazeBinaryFile(MazeMap& a_mazeMap, string a_outputFileName)
+{
+  vector<Position> entrances;
+  vector<Position> dragons;
+  listMazeMapTiles(a_mazeMap, 'e', entrances);
+  listMazeMapTiles(a_mazeMap, 'd', dragons);
+
+  /** HEADER **/
+
+  MazeBinaryHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.tag, MAZE_BINARY_TAG, sizeof(header.tag));
+  header.version = MAZE_BINARY_VERSION;
+  header.rows = a_mazeMap.rows;
+  header.cols = a_mazeMap.cols;
+  header.wordsPerRow = a_mazeMap.openWords;
+  header.entranceCount = entrances.size();
+  header.dragonCount = dragons.size();
+  header.landmarkOffset = sizeof(header);
+
+  unsigned long long landmarkBytes =
+    (entrances.size() + dragons.size()) * 2 * sizeof(unsigned int);
+  header.bitmapOffset = (header.landmarkOffset + landmarkBytes +
+			 MAZE_BINARY_ALIGN - 1) / MAZE_BINARY_ALIGN *
+    MAZE_BINARY_ALIGN;
+
+  /** LANDMARKS **/
+
+  vector<unsigned int> landmarks;
+  for(unsigned int i = 0; i < entrances.size(); i++)
+    {
+      landmarks.push_back(entrances[i].x);
+      landmarks.push_back(entrances[i].y);
+    }
+  for(unsigned int i = 0; i < dragons.size(); i++)
+    {
+      landmarks.push_back(dragons[i].x);
+      landmarks.push_back(dragons[i].y);
+    }
+
+  // Zeroes up to the bitmap
+  landmarks.resize((header.bitmapOffset - header.landmarkOffset) /
+		   sizeof(unsigned int), 0);
+
+  /** WALL BITMAP **/
+
+  // Everything that can't be moved to is a wall, except the entrances
+  long words = (long)a_mazeMap.rows * a_mazeMap.openWords;
+  vector<unsigned long long> walls(words);
+
+  unsigned long long lastWordMask = ~0ULL;
+  if(a_mazeMap.cols % 64 != 0)
+    lastWordMask = (1ULL << (a_mazeMap.cols % 64)) - 1;
+
+  for(long w = 0; w < words; w++)
+    {
+      walls[w] = ~a_mazeMap.openBits[w];
+      if(w % a_mazeMap.openWords == a_mazeMap.openWords - 1)
+	walls[w] &= lastWordMask;
+    }
+
+  for(unsigned int i = 0; i < entrances.size(); i++)
+    {
+      walls[(long)entrances[i].x * a_mazeMap.openWords +
+	    (entrances[i].y >> 6)] &= ~(1ULL << (entrances[i].y & 63));
+    }
+
+  ofstream outputFile(a_outputFileName.c_str(),
+		      ios::out | ios::binary | ios::trunc);
+  if( !outputFile )
+    return -1;
+
+  outputFile.write((const char*)&header, sizeof(header));
+  if(landmarks.size() > 0)
+    outputFile.write((const char*)&landmarks[0],
+		     landmarks.size() * sizeof(unsigned int));
+  outputFile.write((const char*)&walls[0],
+		   words * sizeof(unsigned long long));
+
+  return outputFile.good() ? 0 : -1;
+}
+
+/*
+ * Purpose : Writes a maze in the text format ("rows cols", then the rows
+ *         : of tiles)
+ * Arguments -
+ *   MazeMap& a_mazeMap : Reference to a MazeMap
+ *   string a_outputFileName : String of output file name
+ * Returns : 0 if the file was written, -1 otherwise
+ */
+int writeMazeTextFile(MazeMap& a_mazeMap, string a_outputFileName)
+{
+  ofstream outputFile(a_outputFileName.c_str(), ios::out | ios::trunc);
+  if( !outputFile )
+    return -1;
+
+  outputFile << a_mazeMap.rows << " " << a_mazeMap.cols << "\n";
+  for(int row = 0; row < a_mazeMap.rows; row++)
+    {
+      outputFile.write(&mazeMapCell(a_mazeMap, row, 0), a_mazeMap.cols);
+      outputFile << "\n";
+    }
+
+  return outputFile.good() ? 0 : -1;
+}
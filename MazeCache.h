@@ -0,0 +1,142 @@
+/* ------------------------------------------------------------------------- *
+ *
+ * Filename : MazeCache.h
+ * Version  : 1.0
+ *
+ * Purpose  : Declares the solution cache, which remembers what solving a
+ *          : maze printed so the same maze, solved the same way, can be
+ *          : answered again without reading or searching it.  Solutions
+ *          : are kept in memory (the least recently used are dropped
+ *          : first) and, optionally, saved in a directory so later runs
+ *          : can use them too.
+ *
+ * ------------------------------------------------------------------------- */
+
+#ifndef H_MazeCache
+#define H_MazeCache
+
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "MazeSearch.h"
+
+using namespace std;
+
+
+//-----------------------------------------------------------------------------
+// "Support" structures (meaning, that they help make code pretty)
+//-----------------------------------------------------------------------------
+
+// Name: MazeCacheKey
+// Purpose: Stores what a solution depends on: the maze file's bytes and
+//        : how the search was done
+struct MazeCacheKey
+{
+  /** Hash and length of the maze file (see hashMazeFile()) **/
+  unsigned long long mazeHash;
+  long long mazeBytes;
+
+  /** The search options that change what is printed **/
+  SearchEngine engine;
+  string heuristic; // name given to findHeuristic()
+  long long maxMemory;
+  bool precheck;
+};
+
+// Name: MazeCacheEntry
+// Purpose: Stores one remembered solution
+struct MazeCacheEntry
+{
+  /** Name of the key (see mazeCacheKeyName()) **/
+  string name;
+
+  /** What solving the maze printed **/
+  string output;
+};
+
+// Name: MazeCache
+// Purpose: Stores the remembered solutions.  Shared by all of a batch's
+//        : threads, so every use holds the lock.
+struct MazeCache
+{
+  /** Bytes of output kept in memory at most, and now **/
+  long long capacity;
+  long long size;
+
+  /** Directory solutions are saved in ("" to keep them in memory only) **/
+  string directory;
+
+  /** Solutions in memory, most recently used first, and where each is
+      in the list by name **/
+  list<MazeCacheEntry> entries;
+  unordered_map<string, list<MazeCacheEntry>::iterator> index;
+
+  mutex lock;
+};
+
+
+//-----------------------------------------------------------------------------
+// Globals
+//-----------------------------------------------------------------------------
+
+/** Bytes of solutions kept in memory unless another size is given **/
+const long long MAZE_CACHE_DEFAULT_SIZE = 64LL << 20;
+
+
+//-----------------------------------------------------------------------------
+// Function signatures
+//-----------------------------------------------------------------------------
+
+void initMazeCache(MazeCache& a_cache, long long a_capacity,
+		   string a_directory);
+  /* Purpose : Sets up an empty cache
+   * Arguments -
+   *   MazeCache& a_cache : The cache
+   *   long long a_capacity : Bytes of solutions to keep in memory
+   *   string a_directory : Directory to save solutions in (created if
+   *                      : missing), or "" for none
+   */
+
+bool hashMazeFile(string a_fileName, unsigned long long& a_hash,
+		  long long& a_bytes);
+  /* Purpose : Hashes a maze file's bytes, eight at a time, without
+   *         : reading the maze out of them
+   * Arguments -
+   *   string a_fileName : The maze file
+   *   unsigned long long& a_hash : Receives the hash
+   *   long long& a_bytes : Receives the file's length
+   * Returns : true if the file could be read
+   */
+
+string mazeCacheKeyName(MazeCacheKey& a_key);
+  /* Purpose : Spells out a key as a name (also used as its file name)
+   * Arguments -
+   *   MazeCacheKey& a_key : The key
+   * Returns : The name
+   */
+
+bool lookupMazeCache(MazeCache& a_cache, MazeCacheKey& a_key,
+		     string& a_output);
+  /* Purpose : Finds a remembered solution, in memory or else in the
+   *         : directory, and marks it the most recently used
+   * Arguments -
+   *   MazeCache& a_cache : The cache
+   *   MazeCacheKey& a_key : What the solution depends on
+   *   string& a_output : Receives what solving the maze printed
+   * Returns : true if the solution was remembered
+   */
+
+void storeMazeCache(MazeCache& a_cache, MazeCacheKey& a_key,
+		    string& a_output);
+  /* Purpose : Remembers a solution (and saves it, if there is a
+   *         : directory), dropping the least recently used ones from
+   *         : memory to make room
+   * Arguments -
+   *   MazeCache& a_cache : The cache
+   *   MazeCacheKey& a_key : What the solution depends on
+   *   string& a_output : What solving the maze printed
+   */
+
+#endif
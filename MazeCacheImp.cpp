@@ -0,0 +1,279 @@
+/* ------------------------------------------------------------------------- *
+ *
+ * Filename : MazeCacheImp.cpp
+ * Version  : 1.0
+ *
+ * Purpose  : Implementation of the solution cache.  A saved solution is a
+ *          : file named after its key, holding the key's name on the first
+ *          : line and then the output.
+ *
+ * ------------------------------------------------------------------------- */
+
+#include <fstream>
+#include <sstream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "MazeCache.h"
+
+
+//-----------------------------------------------------------------------------
+// Helper functions
+//-----------------------------------------------------------------------------
+
+/*
+ * Purpose : Finds the file a solution is saved in
+ * Arguments -
+ *   MazeCache& a_cache : The cache (with a directory)
+ *   string a_name : Name of the solution's key
+ * Returns : Path of the file
+ */
+static string mazeCacheFileName(MazeCache& a_cache, string a_name)
+{
+  return a_cache.directory + "/" + a_name + ".solution";
+}
+
+/*
+ * Purpose : Puts a solution at the front of memory, then drops the least
+ *         : recently used solutions until the rest fit (the lock must be
+ *         : held)
+ * Arguments -
+ *   MazeCache& a_cache : The cache
+ *   string& a_name : Name of the solution's key
+ *   string& a_output : The solution
+ */
+static void keepMazeCacheEntry(MazeCache& a_cache, string& a_name,
+			       string& a_output)
+{
+  if( (long long)a_output.length() > a_cache.capacity )
+    return;
+
+  unordered_map<string, list<MazeCacheEntry>::iterator>::iterator found =
+    a_cache.index.find(a_name);
+  if(found != a_cache.index.end())
+    {
+      a_cache.size -= found->second->output.length();
+      a_cache.entries.erase(found->second);
+      a_cache.index.erase(found);
+    }
+
+  MazeCacheEntry entry;
+  entry.name = a_name;
+  entry.output = a_output;
+  a_cache.entries.push_front(entry);
+  a_cache.index[a_name] = a_cache.entries.begin();
+  a_cache.size += a_output.length();
+
+  while(a_cache.size > a_cache.capacity)
+    {
+      MazeCacheEntry& oldest = a_cache.entries.back();
+      a_cache.size -= oldest.output.length();
+      a_cache.index.erase(oldest.name);
+      a_cache.entries.pop_back();
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// Function definitions
+//-----------------------------------------------------------------------------
+
+/*
+ * Purpose : Sets up an empty cache
+ * Arguments -
+ *   MazeCache& a_cache : The cache
+ *   long long a_capacity : Bytes of solutions to keep in memory
+ *   string a_directory : Directory to save solutions in, or "" for none
+ */
+void initMazeCache(MazeCache& a_cache, long long a_capacity,
+		   string a_directory)
+{
+  a_cache.capacity = a_capacity;
+  a_cache.size = 0;
+  a_cache.directory = a_directory;
+  a_cache.entries.clear();
+  a_cache.index.clear();
+
+  // An existing directory is fine; one that can't be made is found out
+  // when the first solution fails to save
+  if(a_directory.length() > 0)
+    mkdir(a_directory.c_str(), 0777);
+}
+
+/*
+ * Purpose : Hashes a maze file's bytes, eight at a time
+ * Arguments -
+ *   string a_fileName : The maze file
+ *   unsigned long long& a_hash : Receives the hash
+ *   long long& a_bytes : Receives the file's length
+ * Returns : true if the file could be read
+ */
+bool hashMazeFile(string a_fileName, unsigned long long& a_hash,
+		  long long& a_bytes)
+{
+  const unsigned long long PRIME = 1099511628211ULL;
+  unsigned long long hash = 14695981039346656037ULL;
+
+  int fd = open(a_fileName.c_str(), O_RDONLY);
+  if(fd < 0)
+    return false;
+
+  struct stat fileStat;
+  if( (fstat(fd, &fileStat) != 0) || !(S_ISREG(fileStat.st_mode)) )
+    {
+      close(fd);
+      return false;
+    }
+
+  size_t length = fileStat.st_size;
+  if(length > 0)
+    {
+      void* mapping = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+      if(mapping == MAP_FAILED)
+	{
+	  close(fd);
+	  return false;
+	}
+
+      const unsigned char* file = (const unsigned char*)mapping;
+      size_t i = 0;
+      unsigned long long word;
+
+      for( ; i + 8 <= length; i += 8)
+	{
+	  memcpy(&word, file + i, 8);
+	  hash = (hash ^ word) * PRIME;
+	  hash ^= hash >> 32;
+	}
+
+      // The last few bytes, if the length isn't a multiple of eight
+      word = 0;
+      memcpy(&word, file + i, length - i);
+      hash = (hash ^ word) * PRIME;
+      hash ^= hash >> 32;
+
+      munmap(mapping, length);
+    }
+
+  close(fd);
+
+  a_hash = (hash ^ length) * PRIME;
+  a_bytes = length;
+  return true;
+}
+
+/*
+ * Purpose : Spells out a key as a name (also used as its file name)
+ * Arguments -
+ *   MazeCacheKey& a_key : The key
+ * Returns : The name
+ */
+string mazeCacheKeyName(MazeCacheKey& a_key)
+{
+  char name[160];
+
+  snprintf(name, sizeof(name), "%016llx-%llx_e%d_h%s_m%lld_p%d",
+	   a_key.mazeHash, (unsigned long long)a_key.mazeBytes,
+	   (int)a_key.engine, a_key.heuristic.c_str(), a_key.maxMemory,
+	   (int)a_key.precheck);
+
+  return name;
+}
+
+/*
+ * Purpose : Finds a remembered solution, in memory or else in the
+ *         : directory, and marks it the most recently used
+ * Arguments -
+ *   MazeCache& a_cache : The cache
+ *   MazeCacheKey& a_key : What the solution depends on
+ *   string& a_output : Receives what solving the maze printed
+ * Returns : true if the solution was remembered
+ */
+bool lookupMazeCache(MazeCache& a_cache, MazeCacheKey& a_key,
+		     string& a_output)
+{
+  string name = mazeCacheKeyName(a_key);
+
+  {
+    unique_lock<mutex> guard(a_cache.lock);
+
+    unordered_map<string, list<MazeCacheEntry>::iterator>::iterator found =
+      a_cache.index.find(name);
+    if(found != a_cache.index.end())
+      {
+	a_cache.entries.splice(a_cache.entries.begin(), a_cache.entries,
+			       found->second);
+	a_output = found->second->output;
+	return true;
+      }
+  }
+
+  if(a_cache.directory.length() == 0)
+    return false;
+
+  // Not in memory, so look for it in the directory (outside the lock, so
+  // other threads aren't kept waiting on the disk)
+  ifstream saved(mazeCacheFileName(a_cache, name).c_str(), ios::binary);
+  string savedName;
+  if( !saved || !(getline(saved, savedName)) || (savedName != name) )
+    return false;
+
+  ostringstream output;
+  output << saved.rdbuf();
+  a_output = output.str();
+
+  unique_lock<mutex> guard(a_cache.lock);
+  keepMazeCacheEntry(a_cache, name, a_output);
+
+  return true;
+}
+
+/*
+ * Purpose : Remembers a solution (and saves it, if there is a directory)
+ * Arguments -
+ *   MazeCache& a_cache : The cache
+ *   MazeCacheKey& a_key : What the solution depends on
+ *   string& a_output : What solving the maze printed
+ */
+void storeMazeCache(MazeCache& a_cache, MazeCacheKey& a_key,
+		    string& a_output)
+{
+  string name = mazeCacheKeyName(a_key);
+
+  {
+    unique_lock<mutex> guard(a_cache.lock);
+    keepMazeCacheEntry(a_cache, name, a_output);
+  }
+
+  if(a_cache.directory.length() == 0)
+    return;
+
+  // Write a temporary file and rename it into place, so a run reading
+  // the directory never sees half a solution
+  string fileName = mazeCacheFileName(a_cache, name);
+  string tempFileName = fileName + ".XXXXXX";
+  int fd = mkstemp(&tempFileName[0]);
+  if(fd < 0)
+    return;
+
+  string contents = name + "\n" + a_output;
+  size_t written = 0;
+  while(written < contents.length())
+    {
+      ssize_t count = write(fd, contents.data() + written,
+			    contents.length() - written);
+      if(count <= 0)
+	break;
+      written += count;
+    }
+  close(fd);
+
+  if( (written < contents.length()) ||
+      (rename(tempFileName.c_str(), fileName.c_str()) != 0) )
+    unlink(tempFileName.c_str());
+}
@@ -0,0 +1,96 @@
+/* ------------------------------------------------------------------------- *
+ *
+ * Filename : MazeField.h
+ * Version  : 1.0
+ *
+ * Purpose  : Declares the distance field of a maze: for every cell, the
+ *          : number of moves to the nearest dragon and the direction of
+ *          : the first one.  It is worked out once with a breadth-first
+ *          : search from the dragons and can be saved next to the maze,
+ *          : after which the path from any cell is read straight off it.
+ *
+ * ------------------------------------------------------------------------- */
+
+#ifndef H_MazeField
+#define H_MazeField
+
+#include <string>
+#include <vector>
+
+#include "MazeApp.h"
+
+using namespace std;
+
+
+//-----------------------------------------------------------------------------
+// "Support" structures (meaning, that they help make code pretty)
+//-----------------------------------------------------------------------------
+
+// Name: DistanceField
+// Purpose: Stores the moves from every cell of a maze to the nearest dragon
+struct DistanceField
+{
+  int rows;
+  int cols;
+
+  /** Hash of the maze it was worked out for (see hashMazeMap()) **/
+  unsigned long long mazeHash;
+
+  /** Per cell (rows*cols, row-major): moves to the nearest dragon, or
+      UNREACHABLE_CELL **/
+  vector<int> distance;
+
+  /** Per cell: direction of the first of those moves (0 on dragons and
+      cells that can't reach one) **/
+  vector<char> nextDir;
+};
+
+
+//-----------------------------------------------------------------------------
+// Globals
+//-----------------------------------------------------------------------------
+
+/** Distance of a cell that no dragon can be reached from **/
+const int UNREACHABLE_CELL = -1;
+
+
+//-----------------------------------------------------------------------------
+// Function signatures
+//-----------------------------------------------------------------------------
+
+void buildDistanceField(MazeMap& a_mazeMap, DistanceField& a_field);
+  /* Purpose : Works out the distance field of a maze with one breadth-first
+   *         : search out from all of its dragons
+   * Arguments -
+   *   MazeMap& a_mazeMap : Reference to a scanned MazeMap
+   *   DistanceField& a_field : Receives the field
+   */
+
+bool saveDistanceField(DistanceField& a_field, string a_fileName);
+  /* Purpose : Writes a distance field to a file
+   * Arguments -
+   *   DistanceField& a_field : The field
+   *   string a_fileName : Name of the file
+   * Returns : true if it was written
+   */
+
+bool loadDistanceField(DistanceField& a_field, string a_fileName);
+  /* Purpose : Reads a distance field written by saveDistanceField()
+   * Arguments -
+   *   DistanceField& a_field : Receives the field
+   *   string a_fileName : Name of the file
+   * Returns : true if it was read (false if missing, or not a field file)
+   */
+
+bool queryDistanceField(DistanceField& a_field, Position a_startPos,
+			PackedPath& a_path);
+  /* Purpose : Reads the path from a cell to the nearest dragon off a
+   *         : distance field, in time proportional to its length
+   * Arguments -
+   *   DistanceField& a_field : The field
+   *   Position a_startPos : Cell to start from
+   *   PackedPath& a_path : Receives the moves
+   * Returns : true if a dragon can be reached from the cell
+   */
+
+#endif
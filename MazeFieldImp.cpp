@@ -0,0 +1,198 @@
+/* ------------------------------------------------------------------------- *
+ *
+ * Filename : MazeFieldImp.cpp
+ * Version  : 1.0
+ *
+ * Purpose  : Implementation of the distance field.  Field files hold an
+ *          : 8-byte tag, the size and maze hash, then the distance and
+ *          : direction grids, all in the machine's own byte order.
+ *
+ * ------------------------------------------------------------------------- */
+
+#include <fstream>
+#include <string.h>
+
+#include "MazeField.h"
+#include "MazeScan.h"
+#include "Queue.h"
+
+
+//-----------------------------------------------------------------------------
+// Globals
+//-----------------------------------------------------------------------------
+
+/** Directions (in the order the search engines use), with their offsets;
+    direction i+2 (mod 4) undoes direction i **/
+const char FIELD_DIRS[4] = { EAST, NORTH, WEST, SOUTH };
+const int FIELD_DROW[4] = { 0, -1, 0, 1 };
+const int FIELD_DCOL[4] = { 1, 0, -1, 0 };
+
+/** Tag at the start of every field file **/
+const char FIELD_FILE_TAG[8] = { 'M', 'A', 'Z', 'E', 'F', 'L', 'D', '1' };
+
+
+//-----------------------------------------------------------------------------
+// Function definitions
+//-----------------------------------------------------------------------------
+
+/*
+ * Purpose : Works out the distance field of a maze with one breadth-first
+ *         : search out from all of its dragons.  The search runs against
+ *         : the direction of travel: a cell is given a distance when a
+ *         : reached open cell next to it could be moved to from it, so
+ *         : entrances get one too, but are never passed through.
+ * Arguments -
+ *   MazeMap& a_mazeMap : Reference to a scanned MazeMap
+ *   DistanceField& a_field : Receives the field
+ */
+void buildDistanceField(MazeMap& a_mazeMap, DistanceField& a_field)
+{
+  a_field.rows = a_mazeMap.rows;
+  a_field.cols = a_mazeMap.cols;
+  a_field.mazeHash = hashMazeMap(a_mazeMap);
+  a_field.distance.assign(a_mazeMap.rows * a_mazeMap.cols, UNREACHABLE_CELL);
+  a_field.nextDir.assign(a_mazeMap.rows * a_mazeMap.cols, 0);
+
+  Queue<int> frontier(2 * (a_mazeMap.rows + a_mazeMap.cols));
+
+  vector<Position> dragons;
+  listMazeMapTiles(a_mazeMap, 'd', dragons);
+  for(unsigned int i = 0; i < dragons.size(); i++)
+    {
+      int goal = mazeMapIndex(a_mazeMap, dragons[i].x, dragons[i].y);
+      a_field.distance[goal] = 0;
+      frontier.addQueue(goal);
+    }
+
+  while( !(frontier.isEmptyQueue()) )
+    {
+      int cell = frontier.front();
+      frontier.deleteQueue();
+
+      int row = cell / a_mazeMap.cols;
+      int col = cell % a_mazeMap.cols;
+
+      for(int i = 0; i < 4; i++)
+	{
+	  int prevRow = row + FIELD_DROW[i];
+	  int prevCol = col + FIELD_DCOL[i];
+
+	  if( (prevRow < 0) || (prevRow >= a_mazeMap.rows) ||
+	      (prevCol < 0) || (prevCol >= a_mazeMap.cols) )
+	    continue;
+
+	  int prev = mazeMapIndex(a_mazeMap, prevRow, prevCol);
+	  if(a_field.distance[prev] != UNREACHABLE_CELL)
+	    continue;
+
+	  bool open = mazeMapOpenTile(a_mazeMap, prevRow, prevCol);
+	  if( open || (mazeMapCell(a_mazeMap, prevRow, prevCol) == 'e') )
+	    {
+	      a_field.distance[prev] = a_field.distance[cell] + 1;
+	      a_field.nextDir[prev] = FIELD_DIRS[(i + 2) % 4];
+
+	      if(open)
+		frontier.addQueue(prev);
+	    }
+	}
+    }
+}
+
+/*
+ * Purpose : Writes a distance field to a file
+ * Arguments -
+ *   DistanceField& a_field : The field
+ *   string a_fileName : Name of the file
+ * Returns : true if it was written
+ */
+bool saveDistanceField(DistanceField& a_field, string a_fileName)
+{
+  ofstream outFile(a_fileName.c_str(), ios::out | ios::binary | ios::trunc);
+  if( !outFile )
+    return false;
+
+  size_t cells = a_field.distance.size();
+
+  outFile.write(FIELD_FILE_TAG, sizeof(FIELD_FILE_TAG));
+  outFile.write((const char*)&a_field.rows, sizeof(a_field.rows));
+  outFile.write((const char*)&a_field.cols, sizeof(a_field.cols));
+  outFile.write((const char*)&a_field.mazeHash, sizeof(a_field.mazeHash));
+  outFile.write((const char*)&a_field.distance[0], cells * sizeof(int));
+  outFile.write(&a_field.nextDir[0], cells);
+
+  return outFile.good();
+}
+
+/*
+ * Purpose : Reads a distance field written by saveDistanceField()
+ * Arguments -
+ *   DistanceField& a_field : Receives the field
+ *   string a_fileName : Name of the file
+ * Returns : true if it was read (false if missing, or not a field file)
+ */
+bool loadDistanceField(DistanceField& a_field, string a_fileName)
+{
+  ifstream inFile(a_fileName.c_str(), ios::in | ios::binary);
+  if( !inFile )
+    return false;
+
+  char tag[sizeof(FIELD_FILE_TAG)];
+  inFile.read(tag, sizeof(tag));
+  inFile.read((char*)&a_field.rows, sizeof(a_field.rows));
+  inFile.read((char*)&a_field.cols, sizeof(a_field.cols));
+  inFile.read((char*)&a_field.mazeHash, sizeof(a_field.mazeHash));
+
+  if( !inFile || (memcmp(tag, FIELD_FILE_TAG, sizeof(tag)) != 0) ||
+      (a_field.rows <= 0) || (a_field.cols <= 0) )
+    return false;
+
+  // The size must also match what is left of the file
+  size_t cells = (size_t)a_field.rows * a_field.cols;
+  streampos dataStart = inFile.tellg();
+  inFile.seekg(0, ios::end);
+  if( (size_t)(inFile.tellg() - dataStart) != cells * (sizeof(int) + 1) )
+    return false;
+  inFile.seekg(dataStart);
+
+  a_field.distance.resize(cells);
+  a_field.nextDir.resize(cells);
+  inFile.read((char*)&a_field.distance[0], cells * sizeof(int));
+  inFile.read(&a_field.nextDir[0], cells);
+
+  return inFile.good();
+}
+
+/*
+ * Purpose : Reads the path from a cell to the nearest dragon off a
+ *         : distance field, in time proportional to its length
+ * Arguments -
+ *   DistanceField& a_field : The field
+ *   Position a_startPos : Cell to start from
+ *   PackedPath& a_path : Receives the moves
+ * Returns : true if a dragon can be reached from the cell
+ */
+bool queryDistanceField(DistanceField& a_field, Position a_startPos,
+			PackedPath& a_path)
+{
+  if( (a_startPos.x < 0) || (a_startPos.x >= a_field.rows) ||
+      (a_startPos.y < 0) || (a_startPos.y >= a_field.cols) )
+    return false;
+
+  int cell = a_startPos.x * a_field.cols + a_startPos.y;
+  int length = a_field.distance[cell];
+  if(length == UNREACHABLE_CELL)
+    return false;
+
+  a_path.setStart(a_startPos.x, a_startPos.y);
+  a_path.resize(length);
+
+  Position pos = a_startPos;
+  for(int i = 0; i < length; i++)
+    {
+      char dir = a_field.nextDir[pos.x * a_field.cols + pos.y];
+      a_path.setMove(i, dir);
+      pos = PackedPath::step(pos, dir);
+    }
+
+  return true;
+}
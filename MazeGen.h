@@ -0,0 +1,76 @@
+/* ------------------------------------------------------------------------- *
+ *
+ * Filename : MazeGen.h
+ * Version  : 1.0
+ *
+ * Purpose  : Declares the maze generator used by the benchmark.  Every
+ *          : style puts the entrance near the top left corner and a
+ *          : dragon elsewhere (or several, for the dragons style), and
+ *          : the same seed always gives the same maze.
+ *
+ * ------------------------------------------------------------------------- */
+
+#ifndef H_MazeGen
+#define H_MazeGen
+
+#include <string>
+
+#include "MazeApp.h"
+
+using namespace std;
+
+
+//-----------------------------------------------------------------------------
+// "Support" structures (meaning, that they help make code pretty)
+//-----------------------------------------------------------------------------
+
+// Name: MazeStyle
+// Purpose: Kinds of maze the generator can make
+enum MazeStyle
+{
+  STYLE_BACKTRACKER, // perfect maze carved by a randomized depth-first walk
+  STYLE_OPEN,        // one big room with walls only around the edge
+  STYLE_SPIRAL,      // a single corridor winding in to the dragon
+  STYLE_UNSOLVABLE,  // a backtracker maze with the dragon walled in
+  STYLE_DRAGONS      // a backtracker maze with loops and several dragons
+};
+
+
+//-----------------------------------------------------------------------------
+// Globals
+//-----------------------------------------------------------------------------
+
+/** Smallest number of rows or columns a generated maze has **/
+const int MAZE_GEN_MIN_SIZE = 5;
+
+/** Dragons the dragons style scatters, besides the one in the top right
+    corner (the first on the map, and usually not the nearest) **/
+const int MAZE_GEN_EXTRA_DRAGONS = 8;
+
+
+//-----------------------------------------------------------------------------
+// Function signatures
+//-----------------------------------------------------------------------------
+
+bool findMazeStyle(string a_name, MazeStyle& a_style);
+  /* Purpose : Looks up a maze style by name ("backtracker", "open",
+   *         : "spiral", "unsolvable" or "dragons")
+   * Arguments -
+   *   string a_name : Name of the style
+   *   MazeStyle& a_style : Receives the style
+   * Returns : true if the name is known
+   */
+
+void generateMaze(MazeStyle a_style, int a_rows, int a_cols,
+		  unsigned int a_seed, MazeMap& a_mazeMap);
+  /* Purpose : Generates a maze
+   * Arguments -
+   *   MazeStyle a_style : Kind of maze
+   *   int a_rows : Number of rows (at least MAZE_GEN_MIN_SIZE)
+   *   int a_cols : Number of columns (at least MAZE_GEN_MIN_SIZE)
+   *   unsigned int a_seed : Seed for the random choices
+   *   MazeMap& a_mazeMap : Receives the maze (scanned, ready to solve;
+   *                      : free it with destroyMazeMap())
+   */
+
+#endif
@@ -0,0 +1,307 @@
+/* ------------------------------------------------------------------------- *
+ *
+ * Filename : MazeGenImp.cpp
+ * Version  : 1.0
+ *
+ * Purpose  : Implementation of the maze generator.  Corridors are carved
+ *          : between cells on odd rows and columns, so walls are always
+ *          : one tile thick.
+ *
+ * ------------------------------------------------------------------------- */
+
+#include <vector>
+#include <string.h>
+
+#include "MazeGen.h"
+#include "MazeScan.h"
+
+
+//-----------------------------------------------------------------------------
+// Globals
+//-----------------------------------------------------------------------------
+
+/** Direction offsets, clockwise from east **/
+const int GEN_DROW[4] = { 0, 1, 0, -1 };
+const int GEN_DCOL[4] = { 1, 0, -1, 0 };
+
+
+//-----------------------------------------------------------------------------
+// Helper functions
+//-----------------------------------------------------------------------------
+
+/*
+ * Purpose : Steps a xorshift random number generator
+ * Arguments -
+ *   unsigned int& a_state : Generator state (never 0)
+ * Returns : The next random number
+ */
+static unsigned int nextRandom(unsigned int& a_state)
+{
+  a_state ^= a_state << 13;
+  a_state ^= a_state >> 17;
+  a_state ^= a_state << 5;
+  return a_state;
+}
+
+/*
+ * Purpose : Finds the last odd row (or column) inside the outer wall
+ * Arguments -
+ *   int a_size : Number of rows (or columns)
+ * Returns : The largest odd index less than a_size - 1
+ */
+static int lastOddIndex(int a_size)
+{
+  return ((a_size - 2) % 2 == 1) ? a_size - 2 : a_size - 3;
+}
+
+/*
+ * Purpose : Carves a perfect maze (exactly one way between any two cells)
+ *         : with a randomized depth-first walk from the top left cell
+ * Arguments -
+ *   MazeMap& a_mazeMap : Map filled with walls
+ *   unsigned int& a_random : Random number generator state
+ */
+static void carveBacktracker(MazeMap& a_mazeMap, unsigned int& a_random)
+{
+  int lastRow = lastOddIndex(a_mazeMap.rows);
+  int lastCol = lastOddIndex(a_mazeMap.cols);
+
+  vector<Position> path;
+  Position start;
+  start.x = 1;
+  start.y = 1;
+  mazeMapCell(a_mazeMap, 1, 1) = ' ';
+  path.push_back(start);
+
+  while( !(path.empty()) )
+    {
+      Position cell = path.back();
+
+      // Directions leading to cells not carved yet
+      int dirs[4];
+      int dirCount = 0;
+      for(int i = 0; i < 4; i++)
+	{
+	  int row = cell.x + 2 * GEN_DROW[i];
+	  int col = cell.y + 2 * GEN_DCOL[i];
+
+	  if( (row >= 1) && (row <= lastRow) && (col >= 1) &&
+	      (col <= lastCol) && (mazeMapCell(a_mazeMap, row, col) == '*') )
+	    dirs[dirCount++] = i;
+	}
+
+      if(dirCount == 0)
+	{
+	  path.pop_back();
+	  continue;
+	}
+
+      int dir = dirs[nextRandom(a_random) % dirCount];
+      mazeMapCell(a_mazeMap, cell.x + GEN_DROW[dir], cell.y + GEN_DCOL[dir]) =
+	' ';
+
+      Position next;
+      next.x = cell.x + 2 * GEN_DROW[dir];
+      next.y = cell.y + 2 * GEN_DCOL[dir];
+      mazeMapCell(a_mazeMap, next.x, next.y) = ' ';
+      path.push_back(next);
+    }
+}
+
+/*
+ * Purpose : Carves one corridor spiralling clockwise in from the top left
+ *         : cell, turning whenever it meets the edge or itself
+ * Arguments -
+ *   MazeMap& a_mazeMap : Map filled with walls
+ * Returns : The cell the corridor ends at
+ */
+static Position carveSpiral(MazeMap& a_mazeMap)
+{
+  int lastRow = lastOddIndex(a_mazeMap.rows);
+  int lastCol = lastOddIndex(a_mazeMap.cols);
+
+  Position cell;
+  cell.x = 1;
+  cell.y = 1;
+  mazeMapCell(a_mazeMap, 1, 1) = ' ';
+
+  int dir = 0;
+  int turns = 0;
+
+  // Two turns in a row without moving means the middle is reached
+  while(turns < 2)
+    {
+      int row = cell.x + 2 * GEN_DROW[dir];
+      int col = cell.y + 2 * GEN_DCOL[dir];
+
+      if( (row >= 1) && (row <= lastRow) && (col >= 1) && (col <= lastCol) &&
+	  (mazeMapCell(a_mazeMap, row, col) == '*') )
+	{
+	  mazeMapCell(a_mazeMap, cell.x + GEN_DROW[dir],
+		      cell.y + GEN_DCOL[dir]) = ' ';
+	  mazeMapCell(a_mazeMap, row, col) = ' ';
+	  cell.x = row;
+	  cell.y = col;
+	  turns = 0;
+	}
+      else
+	{
+	  dir = (dir + 1) % 4;
+	  turns++;
+	}
+    }
+
+  return cell;
+}
+
+/*
+ * Purpose : Knocks through random walls between carved cells, so there is
+ *         : more than one way between them
+ * Arguments -
+ *   MazeMap& a_mazeMap : Map with a maze carved in it
+ *   unsigned int& a_random : Random number generator state
+ */
+static void carveLoops(MazeMap& a_mazeMap, unsigned int& a_random)
+{
+  int lastRow = lastOddIndex(a_mazeMap.rows);
+  int lastCol = lastOddIndex(a_mazeMap.cols);
+  long walls = (long)lastRow * lastCol / 16;
+
+  for(long i = 0; i < walls; i++)
+    {
+      // A cell, and the wall beside it to the east or south
+      int row = 1 + 2 * (nextRandom(a_random) % ((lastRow + 1) / 2));
+      int col = 1 + 2 * (nextRandom(a_random) % ((lastCol + 1) / 2));
+      int dir = nextRandom(a_random) % 2;
+
+      if( (row + 2 * GEN_DROW[dir] <= lastRow) &&
+	  (col + 2 * GEN_DCOL[dir] <= lastCol) )
+	mazeMapCell(a_mazeMap, row + GEN_DROW[dir], col + GEN_DCOL[dir]) =
+	  ' ';
+    }
+}
+
+/*
+ * Purpose : Puts dragons on random carved cells (never the entrance's)
+ * Arguments -
+ *   MazeMap& a_mazeMap : Map with a maze carved in it
+ *   unsigned int& a_random : Random number generator state
+ *   int a_count : Number of dragons
+ */
+static void scatterDragons(MazeMap& a_mazeMap, unsigned int& a_random,
+			   int a_count)
+{
+  int lastRow = lastOddIndex(a_mazeMap.rows);
+  int lastCol = lastOddIndex(a_mazeMap.cols);
+
+  for(int i = 0; i < a_count; i++)
+    {
+      int row = 1 + 2 * (nextRandom(a_random) % ((lastRow + 1) / 2));
+      int col = 1 + 2 * (nextRandom(a_random) % ((lastCol + 1) / 2));
+
+      if( (row != 1) || (col != 1) )
+	mazeMapCell(a_mazeMap, row, col) = 'd';
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// Function definitions
+//-----------------------------------------------------------------------------
+
+/*
+ * Purpose : Looks up a maze style by name
+ * Arguments -
+ *   string a_name : Name of the style
+ *   MazeStyle& a_style : Receives the style
+ * Returns : true if the name is known
+ */
+bool findMazeStyle(string a_name, MazeStyle& a_style)
+{
+  if(a_name == "backtracker")
+    a_style = STYLE_BACKTRACKER;
+  else if(a_name == "open")
+    a_style = STYLE_OPEN;
+  else if(a_name == "spiral")
+    a_style = STYLE_SPIRAL;
+  else if(a_name == "unsolvable")
+    a_style = STYLE_UNSOLVABLE;
+  else if(a_name == "dragons")
+    a_style = STYLE_DRAGONS;
+  else
+    return false;
+
+  return true;
+}
+
+/*
+ * Purpose : Generates a maze
+ * Arguments -
+ *   MazeStyle a_style : Kind of maze
+ *   int a_rows : Number of rows (at least MAZE_GEN_MIN_SIZE)
+ *   int a_cols : Number of columns (at least MAZE_GEN_MIN_SIZE)
+ *   unsigned int a_seed : Seed for the random choices
+ *   MazeMap& a_mazeMap : Receives the maze (scanned, ready to solve)
+ */
+void generateMaze(MazeStyle a_style, int a_rows, int a_cols,
+		  unsigned int a_seed, MazeMap& a_mazeMap)
+{
+  a_mazeMap.rows = a_rows;
+  a_mazeMap.cols = a_cols;
+  a_mazeMap.stride = a_cols;
+  a_mazeMap.map = new char[(long)a_rows * a_cols];
+  a_mazeMap.visited = NULL;
+  a_mazeMap.mapping = NULL;
+  a_mazeMap.mappingLength = 0;
+  a_mazeMap.openBits = NULL;
+
+  // xorshift never leaves 0, so that seed is moved
+  unsigned int random = (a_seed != 0) ? a_seed : 0x9e3779b9;
+
+  Position dragon;
+  dragon.x = lastOddIndex(a_rows);
+  dragon.y = lastOddIndex(a_cols);
+
+  if(a_style == STYLE_OPEN)
+    {
+      memset(a_mazeMap.map, ' ', (long)a_rows * a_cols);
+      for(int row = 0; row < a_rows; row++)
+	{
+	  mazeMapCell(a_mazeMap, row, 0) = '*';
+	  mazeMapCell(a_mazeMap, row, a_cols - 1) = '*';
+	}
+      memset(&mazeMapCell(a_mazeMap, 0, 0), '*', a_cols);
+      memset(&mazeMapCell(a_mazeMap, a_rows - 1, 0), '*', a_cols);
+    }
+  else
+    {
+      memset(a_mazeMap.map, '*', (long)a_rows * a_cols);
+
+      if(a_style == STYLE_SPIRAL)
+	dragon = carveSpiral(a_mazeMap);
+      else
+	carveBacktracker(a_mazeMap, random);
+
+      // Wall the dragon in
+      if(a_style == STYLE_UNSOLVABLE)
+	{
+	  for(int i = 0; i < 4; i++)
+	    mazeMapCell(a_mazeMap, dragon.x + GEN_DROW[i],
+			dragon.y + GEN_DCOL[i]) = '*';
+	}
+
+      // The first dragon on the map goes in the top right corner, so a
+      // search aiming only at it is led away from the nearer ones
+      if(a_style == STYLE_DRAGONS)
+	{
+	  carveLoops(a_mazeMap, random);
+	  scatterDragons(a_mazeMap, random, MAZE_GEN_EXTRA_DRAGONS);
+	  dragon.x = 1;
+	}
+    }
+
+  mazeMapCell(a_mazeMap, 1, 1) = 'e';
+  mazeMapCell(a_mazeMap, dragon.x, dragon.y) = 'd';
+
+  scanMazeMap(a_mazeMap);
+}
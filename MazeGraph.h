@@ -0,0 +1,91 @@
+/* ------------------------------------------------------------------------- *
+ *
+ * Filename : MazeGraph.h
+ * Version  : 1.0
+ *
+ * Purpose  : Declares the junction graph of a maze: dead ends are filled
+ *          : in, and the corridors left between junctions are collapsed
+ *          : into weighted edges, so a search steps from junction to
+ *          : junction instead of from cell to cell.
+ *
+ * ------------------------------------------------------------------------- */
+
+#ifndef H_MazeGraph
+#define H_MazeGraph
+
+#include <vector>
+
+#include "MazeSearch.h"
+
+using namespace std;
+
+
+//-----------------------------------------------------------------------------
+// "Support" structures (meaning, that they help make code pretty)
+//-----------------------------------------------------------------------------
+
+// Name: JunctionGraph
+// Purpose: Stores the junction graph of a maze.  Junctions are the cells
+//        : left after dead-end filling that don't sit in the middle of a
+//        : corridor (fewer or more than two live neighbours), plus the
+//        : entrance and the dragons.
+struct JunctionGraph
+{
+  /** Per cell (rows*cols): live neighbours, plus KEEP_CELL for the
+      entrance and dragons, or DEAD_CELL for walls and filled dead ends **/
+  vector<unsigned char> degree;
+
+  /** Cells of the junctions, in row-major order **/
+  vector<int> nodeCells;
+
+  /** Corridors leaving junction n are edges edgeStart[n]..
+      edgeStart[n+1]-1: the junction they reach, their length in moves
+      and the direction of their first move **/
+  vector<int> edgeStart;
+  vector<int> edgeTarget;
+  vector<int> edgeLength;
+  vector<char> edgeDir;
+
+  /** Number of dead-end cells filled in **/
+  long filledCount;
+};
+
+
+//-----------------------------------------------------------------------------
+// Globals
+//-----------------------------------------------------------------------------
+
+/** Degree of a cell that can't be moved to (wall or filled dead end) **/
+const unsigned char DEAD_CELL = 0xff;
+
+/** Added to the degree of cells that are always junctions (and never
+    filled): the entrance and the dragons **/
+const unsigned char KEEP_CELL = 0x10;
+
+
+//-----------------------------------------------------------------------------
+// Function signatures
+//-----------------------------------------------------------------------------
+
+void buildJunctionGraph(MazeMap& a_mazeMap, Position a_entrancePos,
+			JunctionGraph& a_graph);
+  /* Purpose : Fills in a maze's dead ends and collapses its corridors into
+   *         : a junction graph
+   * Arguments -
+   *   MazeMap& a_mazeMap : Reference to a scanned MazeMap
+   *   Position a_entrancePos : Position of the entrance (never filled)
+   *   JunctionGraph& a_graph : Receives the graph
+   */
+
+MazeSearchResult solveMazeJunctions(MazeMap& a_mazeMap,
+				    Position a_entrancePos);
+  /* Purpose : Finds a shortest path from the entrance to the dragon by
+   *         : searching the junction graph, then expands it back into
+   *         : cell moves
+   * Arguments -
+   *   MazeMap& a_mazeMap : Reference to a MazeMap
+   *   Position a_entrancePos : Position to start searching from
+   * Returns : The search outcome (expanded counts junctions)
+   */
+
+#endif
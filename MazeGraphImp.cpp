@@ -0,0 +1,378 @@
+/* ------------------------------------------------------------------------- *
+ *
+ * Filename : MazeGraphImp.cpp
+ * Version  : 1.0
+ *
+ * Purpose  : Implementation of the junction graph and the search over it
+ *
+ * ------------------------------------------------------------------------- */
+
+#include <algorithm>
+
+#include "MazeGraph.h"
+#include "PriorityQueue.h"
+#include "Queue.h"
+#include "Stack.h"
+
+
+//-----------------------------------------------------------------------------
+// Globals
+//-----------------------------------------------------------------------------
+
+/** Directions (in the order the search engines use), with their offsets **/
+const char GRAPH_DIRS[4] = { EAST, NORTH, WEST, SOUTH };
+const int GRAPH_DROW[4] = { 0, -1, 0, 1 };
+const int GRAPH_DCOL[4] = { 1, 0, -1, 0 };
+
+
+//-----------------------------------------------------------------------------
+// "Support" structures
+//-----------------------------------------------------------------------------
+
+// Name: JunctionNode
+// Purpose: An entry on the junction search's open set
+struct JunctionNode
+{
+  /** Moves from the entrance when pushed **/
+  long long dist;
+
+  /** Index of the junction **/
+  int node;
+
+  bool operator<(const JunctionNode& other) const
+  {
+    return dist < other.dist;
+  }
+};
+
+
+//-----------------------------------------------------------------------------
+// Helper functions
+//-----------------------------------------------------------------------------
+
+/*
+ * Purpose : Finds the neighbour of a cell in a direction, if it is live
+ * Arguments -
+ *   MazeMap& a_mazeMap : Reference to a MazeMap
+ *   JunctionGraph& a_graph : The graph (its degree grid)
+ *   int a_cell : Index of the cell
+ *   int a_dir : Index of the direction
+ * Returns : Index of the neighbour, or -1 if it is off the map or dead
+ */
+static int liveNeighbour(MazeMap& a_mazeMap, JunctionGraph& a_graph,
+			 int a_cell, int a_dir)
+{
+  int next;
+
+  // Only the column needs working out to stay on the map
+  if(a_dir == 0)
+    next = ((a_cell + 1) % a_mazeMap.cols != 0) ? a_cell + 1 : -1;
+  else if(a_dir == 1)
+    next = a_cell - a_mazeMap.cols;
+  else if(a_dir == 2)
+    next = (a_cell % a_mazeMap.cols != 0) ? a_cell - 1 : -1;
+  else
+    next = a_cell + a_mazeMap.cols;
+
+  if( (next < 0) || (next >= (int)a_graph.degree.size()) ||
+      (a_graph.degree[next] == DEAD_CELL) )
+    return -1;
+
+  return next;
+}
+
+/*
+ * Purpose : Is a live cell a junction of the graph?
+ * Arguments -
+ *   JunctionGraph& a_graph : The graph (its degree grid)
+ *   int a_cell : Index of a live cell
+ * Returns : Whether the cell is a junction
+ */
+static bool isJunction(JunctionGraph& a_graph, int a_cell)
+{
+  // (KEEP_CELL makes the degree something other than 2)
+  return a_graph.degree[a_cell] != 2;
+}
+
+/*
+ * Purpose : Steps one cell along a corridor
+ * Arguments -
+ *   MazeMap& a_mazeMap : Reference to a MazeMap
+ *   JunctionGraph& a_graph : The graph
+ *   int a_cell : Index of a corridor cell (two live neighbours)
+ *   int a_prev : Index of the cell it was entered from
+ *   int& a_dir : Receives the index of the direction stepped in
+ * Returns : Index of the next cell
+ */
+static int stepCorridor(MazeMap& a_mazeMap, JunctionGraph& a_graph,
+			int a_cell, int a_prev, int& a_dir)
+{
+  for(a_dir = 0; a_dir < 4; a_dir++)
+    {
+      int next = liveNeighbour(a_mazeMap, a_graph, a_cell, a_dir);
+      if( (next >= 0) && (next != a_prev) )
+	return next;
+    }
+
+  return -1;
+}
+
+
+//-----------------------------------------------------------------------------
+// Program functions
+//-----------------------------------------------------------------------------
+
+/*
+ * Purpose : Fills in a maze's dead ends and collapses its corridors into a
+ *         : junction graph.  A dead end (a live cell with at most one live
+ *         : neighbour, other than the entrance or a dragon) can't be on a
+ *         : shortest path, and filling one may make the cell before it a
+ *         : dead end too, so they are filled from a queue until none are
+ *         : left.  Each corridor is then walked once from each end.
+ * Arguments -
+ *   MazeMap& a_mazeMap : Reference to a scanned MazeMap
+ *   Position a_entrancePos : Position of the entrance (never filled)
+ *   JunctionGraph& a_graph : Receives the graph
+ */
+void buildJunctionGraph(MazeMap& a_mazeMap, Position a_entrancePos,
+			JunctionGraph& a_graph)
+{
+  int cells = a_mazeMap.rows * a_mazeMap.cols;
+  int entrance = mazeMapIndex(a_mazeMap, a_entrancePos.x, a_entrancePos.y);
+
+  /** FIND THE LIVE CELLS AND COUNT THEIR NEIGHBOURS **/
+
+  a_graph.degree.assign(cells, DEAD_CELL);
+  for(int row = 0; row < a_mazeMap.rows; row++)
+    {
+      for(int col = 0; col < a_mazeMap.cols; col++)
+	{
+	  if( mazeMapOpenTile(a_mazeMap, row, col) )
+	    a_graph.degree[mazeMapIndex(a_mazeMap, row, col)] =
+	      (mazeMapCell(a_mazeMap, row, col) == 'd') ? KEEP_CELL : 0;
+	}
+    }
+  a_graph.degree[entrance] = KEEP_CELL;
+
+  Queue<int> deadEnds(64);
+
+  for(int row = 0; row < a_mazeMap.rows; row++)
+    {
+      for(int col = 0; col < a_mazeMap.cols; col++)
+	{
+	  int cell = mazeMapIndex(a_mazeMap, row, col);
+	  if(a_graph.degree[cell] == DEAD_CELL)
+	    continue;
+
+	  // Neighbours in bounds that are live
+	  if( (col + 1 < a_mazeMap.cols) &&
+	      (a_graph.degree[cell + 1] != DEAD_CELL) )
+	    a_graph.degree[cell]++;
+	  if( (row > 0) &&
+	      (a_graph.degree[cell - a_mazeMap.cols] != DEAD_CELL) )
+	    a_graph.degree[cell]++;
+	  if( (col > 0) && (a_graph.degree[cell - 1] != DEAD_CELL) )
+	    a_graph.degree[cell]++;
+	  if( (row + 1 < a_mazeMap.rows) &&
+	      (a_graph.degree[cell + a_mazeMap.cols] != DEAD_CELL) )
+	    a_graph.degree[cell]++;
+
+	  if(a_graph.degree[cell] <= 1)
+	    deadEnds.addQueue(cell);
+	}
+    }
+
+  /** FILL DEAD ENDS **/
+
+  a_graph.filledCount = 0;
+
+  while( !(deadEnds.isEmptyQueue()) )
+    {
+      int cell = deadEnds.front();
+      deadEnds.deleteQueue();
+
+      for(int dir = 0; dir < 4; dir++)
+	{
+	  int next = liveNeighbour(a_mazeMap, a_graph, cell, dir);
+	  if(next < 0)
+	    continue;
+
+	  // The neighbour may become a dead end in turn (a degree of 2
+	  // going to 1; cells that were already dead ends are queued)
+	  a_graph.degree[next]--;
+	  if(a_graph.degree[next] == 1)
+	    deadEnds.addQueue(next);
+	}
+
+      a_graph.degree[cell] = DEAD_CELL;
+      a_graph.filledCount++;
+    }
+
+  /** COLLECT JUNCTIONS **/
+
+  a_graph.nodeCells.clear();
+  for(int cell = 0; cell < cells; cell++)
+    {
+      if( (a_graph.degree[cell] != DEAD_CELL) && isJunction(a_graph, cell) )
+	a_graph.nodeCells.push_back(cell);
+    }
+
+  /** WALK THE CORRIDORS **/
+
+  a_graph.edgeStart.clear();
+  a_graph.edgeTarget.clear();
+  a_graph.edgeLength.clear();
+  a_graph.edgeDir.clear();
+
+  for(unsigned int node = 0; node < a_graph.nodeCells.size(); node++)
+    {
+      a_graph.edgeStart.push_back(a_graph.edgeTarget.size());
+      int from = a_graph.nodeCells[node];
+
+      for(int dir = 0; dir < 4; dir++)
+	{
+	  int cell = liveNeighbour(a_mazeMap, a_graph, from, dir);
+	  if(cell < 0)
+	    continue;
+
+	  int prev = from;
+	  int length = 1;
+	  int stepDir;
+
+	  while( !(isJunction(a_graph, cell)) )
+	    {
+	      int next = stepCorridor(a_mazeMap, a_graph, cell, prev,
+				      stepDir);
+	      prev = cell;
+	      cell = next;
+	      length++;
+	    }
+
+	  // Junctions are in row-major order, so look the end up
+	  int target = lower_bound(a_graph.nodeCells.begin(),
+				   a_graph.nodeCells.end(), cell) -
+	    a_graph.nodeCells.begin();
+
+	  a_graph.edgeTarget.push_back(target);
+	  a_graph.edgeLength.push_back(length);
+	  a_graph.edgeDir.push_back(dir);
+	}
+    }
+  a_graph.edgeStart.push_back(a_graph.edgeTarget.size());
+}
+
+/*
+ * Purpose : Finds a shortest path from the entrance to the dragon by
+ *         : searching the junction graph (Dijkstra's search, since the
+ *         : corridors differ in length), then expands it back into cell
+ *         : moves by walking each corridor on the path again
+ * Arguments -
+ *   MazeMap& a_mazeMap : Reference to a MazeMap
+ *   Position a_entrancePos : Position to start searching from
+ * Returns : The search outcome (expanded counts junctions)
+ */
+MazeSearchResult solveMazeJunctions(MazeMap& a_mazeMap,
+				    Position a_entrancePos)
+{
+  MazeSearchResult result;
+  result.foundDragon = false;
+  result.expanded = 0;
+
+  JunctionGraph graph;
+  buildJunctionGraph(a_mazeMap, a_entrancePos, graph);
+
+  int nodes = graph.nodeCells.size();
+  int entrance = mazeMapIndex(a_mazeMap, a_entrancePos.x, a_entrancePos.y);
+  int start = lower_bound(graph.nodeCells.begin(), graph.nodeCells.end(),
+			  entrance) - graph.nodeCells.begin();
+
+  // -1 means "not reached yet"; parentEdge[start] stays -1
+  vector<long long> dist(nodes, -1);
+  vector<int> parentEdge(nodes, -1);
+
+  PriorityQueue<JunctionNode> openSet(64);
+
+  JunctionNode entry;
+  entry.dist = 0;
+  entry.node = start;
+  dist[start] = 0;
+  openSet.addQueue(entry);
+
+  int goal = -1;
+
+  while( !(openSet.isEmptyQueue()) )
+    {
+      entry = openSet.front();
+      openSet.deleteQueue();
+
+      // Skip entries superseded by a shorter route
+      if(entry.dist != dist[entry.node])
+	continue;
+
+      result.expanded++;
+
+      if(mazeMapCellAt(a_mazeMap, graph.nodeCells[entry.node]) == 'd')
+	{
+	  goal = entry.node;
+	  break;
+	}
+
+      for(int edge = graph.edgeStart[entry.node];
+	  edge < graph.edgeStart[entry.node + 1]; edge++)
+	{
+	  int next = graph.edgeTarget[edge];
+	  long long nextDist = entry.dist + graph.edgeLength[edge];
+
+	  if( (dist[next] == -1) || (nextDist < dist[next]) )
+	    {
+	      dist[next] = nextDist;
+	      parentEdge[next] = edge;
+
+	      JunctionNode nextEntry;
+	      nextEntry.dist = nextDist;
+	      nextEntry.node = next;
+	      openSet.addQueue(nextEntry);
+	    }
+	}
+    }
+
+  if(goal >= 0)
+    {
+      result.foundDragon = true;
+
+      // Edges on the path, last one first (the node an edge leaves from
+      // is the one whose edge range holds it)
+      Stack<int> pathEdges;
+      for(int node = goal; parentEdge[node] >= 0; )
+	{
+	  int edge = parentEdge[node];
+	  pathEdges.push(edge);
+	  node = upper_bound(graph.edgeStart.begin(), graph.edgeStart.end(),
+			     edge) - graph.edgeStart.begin() - 1;
+	}
+
+      result.path.setStart(a_entrancePos.x, a_entrancePos.y);
+
+      int cell = entrance;
+      while( !(pathEdges.isEmptyStack()) )
+	{
+	  int edge = pathEdges.top();
+	  pathEdges.pop();
+
+	  int dir = graph.edgeDir[edge];
+	  int prev = cell;
+	  cell = liveNeighbour(a_mazeMap, graph, cell, dir);
+	  result.path.addMove(GRAPH_DIRS[dir]);
+
+	  for(int i = 1; i < graph.edgeLength[edge]; i++)
+	    {
+	      int next = stepCorridor(a_mazeMap, graph, cell, prev, dir);
+	      prev = cell;
+	      cell = next;
+	      result.path.addMove(GRAPH_DIRS[dir]);
+	    }
+	}
+    }
+
+  return result;
+}
@@ -0,0 +1,71 @@
+/* ------------------------------------------------------------------------- *
+ *
+ * Filename : MazeJump.h
+ * Version  : 1.0
+ *
+ * Purpose  : Declares jump point search for mazes with open rooms.  Of the
+ *          : many equally short ways across a room, only those that move
+ *          : across before they move up or down are searched, and the
+ *          : cells where such a path may turn (jump points) are found
+ *          : ahead of time, so a search crosses a room in one step.
+ *
+ * ------------------------------------------------------------------------- */
+
+#ifndef H_MazeJump
+#define H_MazeJump
+
+#include <vector>
+
+#include "MazeSearch.h"
+
+using namespace std;
+
+
+//-----------------------------------------------------------------------------
+// "Support" structures (meaning, that they help make code pretty)
+//-----------------------------------------------------------------------------
+
+// Name: JumpTable
+// Purpose: Stores how far a jump goes from every cell in each direction.
+//        : A cell is a jump point for moves up or down when it is a
+//        : dragon, or when the tile beside it is open but the tile beside
+//        : the cell before it was not; it is a jump point for moves
+//        : across when it is a dragon, or when a jump up or down from it
+//        : reaches a jump point.
+struct JumpTable
+{
+  /** Per direction (EAST, NORTH, WEST, SOUTH), per cell (rows*cols): n > 0
+      if the next jump point is n moves away, -n if there is none before
+      a wall n moves away **/
+  vector<int> distance[4];
+};
+
+
+//-----------------------------------------------------------------------------
+// Function signatures
+//-----------------------------------------------------------------------------
+
+void buildJumpTable(MazeMap& a_mazeMap, JumpTable& a_table);
+  /* Purpose : Works out how far a jump goes from every cell in each
+   *         : direction, in four sweeps over the maze
+   * Arguments -
+   *   MazeMap& a_mazeMap : Reference to a scanned MazeMap
+   *   JumpTable& a_table : Receives the distances
+   */
+
+MazeSearchResult solveMazeJumpPoints(MazeMap& a_mazeMap,
+				     Position a_entrancePos,
+				     vector<Position>& a_dragons,
+				     MazeHeuristic a_heuristic);
+  /* Purpose : Finds a shortest path from the entrance to the nearest
+   *         : dragon using A* search over jump points, then fills in the
+   *         : moves between them
+   * Arguments -
+   *   MazeMap& a_mazeMap : Reference to a MazeMap
+   *   Position a_entrancePos : Position to start searching from
+   *   vector<Position>& a_dragons : Positions of every dragon (the goals)
+   *   MazeHeuristic a_heuristic : Estimate of the moves left to a goal
+   * Returns : The search outcome (expanded counts jump points)
+   */
+
+#endif
@@ -0,0 +1,368 @@
+/* ------------------------------------------------------------------------- *
+ *
+ * Filename : MazeJumpImp.cpp
+ * Version  : 1.0
+ *
+ * Purpose  : Implementation of jump point search.  Among equally short
+ *          : paths, one that never moves up or down and then across when
+ *          : it could have moved across first is always kept, so a path
+ *          : moving up or down only turns where the tile behind its side
+ *          : is a wall (a forced turn), and a path moving across only
+ *          : turns where a jump up or down leads somewhere.
+ *
+ * ------------------------------------------------------------------------- */
+
+#include <stdlib.h>
+
+#include "MazeJump.h"
+#include "PriorityQueue.h"
+
+
+//-----------------------------------------------------------------------------
+// Globals
+//-----------------------------------------------------------------------------
+
+/** Directions (in the order the search engines use), with their offsets;
+    the even ones move across, the odd ones up or down **/
+const char JUMP_DIRS[4] = { EAST, NORTH, WEST, SOUTH };
+const int JUMP_DROW[4] = { 0, -1, 0, 1 };
+const int JUMP_DCOL[4] = { 1, 0, -1, 0 };
+
+/** Indexes of the directions **/
+const int JUMP_EAST = 0;
+const int JUMP_NORTH = 1;
+const int JUMP_WEST = 2;
+const int JUMP_SOUTH = 3;
+
+
+//-----------------------------------------------------------------------------
+// "Support" structures
+//-----------------------------------------------------------------------------
+
+// Name: JumpNode
+// Purpose: An entry on the jump point search's open set.  Ordered like
+//        : A*'s: by f = g + h, with ties going to the larger g.
+struct JumpNode
+{
+  /** Sort key: (f << 31) - g **/
+  long long key;
+
+  /** Cell index and its cost from the start when pushed **/
+  int cell;
+  int g;
+
+  bool operator<(const JumpNode& other) const
+  {
+    return key < other.key;
+  }
+};
+
+
+//-----------------------------------------------------------------------------
+// Helper functions
+//-----------------------------------------------------------------------------
+
+/*
+ * Purpose : Finds whether moving up or down into a cell must be allowed to
+ *         : turn there: the cell is a dragon, or a tile beside it is open
+ *         : where the tile beside the cell before it is not
+ * Arguments -
+ *   MazeMap& a_mazeMap : Reference to a MazeMap
+ *   int a_row : Row of the cell
+ *   int a_col : Column of the cell
+ *   int a_fromRow : Row of the cell before it
+ * Returns : Whether the cell is a jump point for moves up or down
+ */
+static bool isVerticalJumpPoint(MazeMap& a_mazeMap, int a_row, int a_col,
+				int a_fromRow)
+{
+  if(mazeMapCell(a_mazeMap, a_row, a_col) == 'd')
+    return true;
+
+  for(int side = -1; side <= 1; side += 2)
+    {
+      if( mazeMapIsOpen(a_mazeMap, a_row, a_col + side) &&
+	  !(mazeMapIsOpen(a_mazeMap, a_fromRow, a_col + side)) )
+	return true;
+    }
+
+  return false;
+}
+
+/*
+ * Purpose : Sweeps the maze in one direction, working out how far a jump
+ *         : goes from each cell from how far it goes from the next one
+ * Arguments -
+ *   MazeMap& a_mazeMap : Reference to a MazeMap
+ *   JumpTable& a_table : The table (the vertical distances must already
+ *                      : be there when the horizontal ones are worked out)
+ *   int a_dir : Index of the direction
+ */
+static void sweepJumps(MazeMap& a_mazeMap, JumpTable& a_table, int a_dir)
+{
+  vector<int>& distance = a_table.distance[a_dir];
+  int rows = a_mazeMap.rows;
+  int cols = a_mazeMap.cols;
+
+  // Visit each cell after the one it jumps to
+  bool reverseRows = (JUMP_DROW[a_dir] > 0);
+  bool reverseCols = (JUMP_DCOL[a_dir] > 0);
+
+  for(int i = 0; i < rows; i++)
+    {
+      int row = reverseRows ? rows - 1 - i : i;
+
+      for(int j = 0; j < cols; j++)
+	{
+	  int col = reverseCols ? cols - 1 - j : j;
+
+	  // Every cell gets a distance, since the entrance isn't an open
+	  // tile but the search starts from it
+	  int nextRow = row + JUMP_DROW[a_dir];
+	  int nextCol = col + JUMP_DCOL[a_dir];
+	  int cell = mazeMapIndex(a_mazeMap, row, col);
+
+	  if( !(mazeMapIsOpen(a_mazeMap, nextRow, nextCol)) )
+	    {
+	      distance[cell] = 0;
+	      continue;
+	    }
+
+	  int next = mazeMapIndex(a_mazeMap, nextRow, nextCol);
+	  bool jumpPoint;
+	  if(a_dir % 2 == 1)
+	    jumpPoint = isVerticalJumpPoint(a_mazeMap, nextRow, nextCol, row);
+	  else
+	    jumpPoint = (mazeMapCellAt(a_mazeMap, next) == 'd') ||
+	      (a_table.distance[JUMP_NORTH][next] > 0) ||
+	      (a_table.distance[JUMP_SOUTH][next] > 0);
+
+	  if(jumpPoint)
+	    distance[cell] = 1;
+	  else if(distance[next] > 0)
+	    distance[cell] = distance[next] + 1;
+	  else
+	    distance[cell] = distance[next] - 1;
+	}
+    }
+}
+
+/*
+ * Purpose : Finds the directions worth jumping in from a jump point
+ * Arguments -
+ *   MazeMap& a_mazeMap : Reference to a MazeMap
+ *   int a_cell : Index of the jump point
+ *   unsigned char a_arrivals : Bit d set for each direction d the jump
+ *                            : point was reached in (all four for the
+ *                            : start)
+ * Returns : Bit d set for each direction d to jump in
+ */
+static unsigned char jumpDirections(MazeMap& a_mazeMap, int a_cell,
+				    unsigned char a_arrivals)
+{
+  int row = a_cell / a_mazeMap.cols;
+  int col = a_cell % a_mazeMap.cols;
+  unsigned char dirs = 0;
+
+  for(int a = 0; a < 4; a++)
+    {
+      if( !(a_arrivals & (1 << a)) )
+	continue;
+
+      if(a % 2 == 0)
+	{
+	  // Moving across: on, or up or down
+	  dirs |= (1 << a) | (1 << JUMP_NORTH) | (1 << JUMP_SOUTH);
+	}
+      else
+	{
+	  // Moving up or down: on, or across where the turn is forced
+	  dirs |= (1 << a);
+
+	  int fromRow = row - JUMP_DROW[a];
+	  for(int side = 0; side < 4; side += 2)
+	    {
+	      int sideCol = col + JUMP_DCOL[side];
+	      if( mazeMapIsOpen(a_mazeMap, row, sideCol) &&
+		  !(mazeMapIsOpen(a_mazeMap, fromRow, sideCol)) )
+		dirs |= (1 << side);
+	    }
+	}
+    }
+
+  return dirs;
+}
+
+/*
+ * Purpose : Fills in the moves of a path found between jump points
+ * Arguments -
+ *   MazeMap& a_mazeMap : Reference to a MazeMap
+ *   vector<int>& a_parent : Jump point each jump point was reached from
+ *                         : (-1 for the start)
+ *   int a_cell : Cell the path ends at
+ *   int a_length : Moves from the start to a_cell
+ *   PackedPath& a_path : Receives the moves
+ */
+static void traceJumps(MazeMap& a_mazeMap, vector<int>& a_parent,
+		       int a_cell, int a_length, PackedPath& a_path)
+{
+  a_path.resize(a_length);
+
+  long index = a_length;
+  int cell = a_cell;
+  while(a_parent[cell] != -1)
+    {
+      int from = a_parent[cell];
+      int steps;
+      char dir;
+
+      if(from / a_mazeMap.cols == cell / a_mazeMap.cols)
+	{
+	  steps = abs(cell - from);
+	  dir = (cell > from) ? EAST : WEST;
+	}
+      else
+	{
+	  steps = abs(cell - from) / a_mazeMap.cols;
+	  dir = (cell > from) ? SOUTH : NORTH;
+	}
+
+      for(int i = 0; i < steps; i++)
+	a_path.setMove(--index, dir);
+
+      cell = from;
+    }
+
+  a_path.setStart(cell / a_mazeMap.cols, cell % a_mazeMap.cols);
+}
+
+
+//-----------------------------------------------------------------------------
+// Function definitions
+//-----------------------------------------------------------------------------
+
+/*
+ * Purpose : Works out how far a jump goes from every cell in each
+ *         : direction.  The vertical sweeps go first, since whether a
+ *         : cell is a jump point across depends on the jumps up and down
+ *         : from it.
+ * Arguments -
+ *   MazeMap& a_mazeMap : Reference to a scanned MazeMap
+ *   JumpTable& a_table : Receives the distances
+ */
+void buildJumpTable(MazeMap& a_mazeMap, JumpTable& a_table)
+{
+  long cells = (long)a_mazeMap.rows * a_mazeMap.cols;
+
+  for(int dir = 0; dir < 4; dir++)
+    a_table.distance[dir].assign(cells, 0);
+
+  sweepJumps(a_mazeMap, a_table, JUMP_NORTH);
+  sweepJumps(a_mazeMap, a_table, JUMP_SOUTH);
+  sweepJumps(a_mazeMap, a_table, JUMP_EAST);
+  sweepJumps(a_mazeMap, a_table, JUMP_WEST);
+}
+
+/*
+ * Purpose : Finds a shortest path from the entrance to the nearest dragon
+ *         : using A* search over jump points.  A cell reached at its best
+ *         : cost in more than one direction remembers them all, since
+ *         : each allows different jumps on.
+ * Arguments -
+ *   MazeMap& a_mazeMap : Reference to a MazeMap
+ *   Position a_entrancePos : Position to start searching from
+ *   vector<Position>& a_dragons : Positions of every dragon (the goals)
+ *   MazeHeuristic a_heuristic : Estimate of the moves left to a goal
+ * Returns : The search outcome (expanded counts jump points)
+ */
+MazeSearchResult solveMazeJumpPoints(MazeMap& a_mazeMap,
+				     Position a_entrancePos,
+				     vector<Position>& a_dragons,
+				     MazeHeuristic a_heuristic)
+{
+  MazeSearchResult result;
+  result.foundDragon = false;
+  result.expanded = 0;
+
+  JumpTable table;
+  buildJumpTable(a_mazeMap, table);
+
+  long cells = (long)a_mazeMap.rows * a_mazeMap.cols;
+
+  // -1 means "not reached yet"
+  vector<int> gScore(cells, -1);
+  vector<int> parent(cells, -1);
+  vector<unsigned char> arrivals(cells, 0);
+
+  PriorityQueue<JumpNode> openSet(64);
+
+  JumpNode node;
+  node.cell = mazeMapIndex(a_mazeMap, a_entrancePos.x, a_entrancePos.y);
+  node.g = 0;
+  node.key = ((long long)estimateMovesLeft(a_heuristic, a_entrancePos,
+					   a_dragons) << 31);
+  gScore[node.cell] = 0;
+  arrivals[node.cell] = 0x0f;
+  openSet.addQueue(node);
+
+  while( !(openSet.isEmptyQueue()) )
+    {
+      node = openSet.front();
+      openSet.deleteQueue();
+
+      // Skip entries superseded by a cheaper route
+      if(node.g != gScore[node.cell])
+	continue;
+
+      result.expanded++;
+
+      if(mazeMapCellAt(a_mazeMap, node.cell) == 'd')
+	{
+	  result.foundDragon = true;
+	  traceJumps(a_mazeMap, parent, node.cell, node.g, result.path);
+	  break;
+	}
+
+      unsigned char dirs = jumpDirections(a_mazeMap, node.cell,
+					  arrivals[node.cell]);
+
+      for(int i = 0; i < 4; i++)
+	{
+	  int distance = table.distance[i][node.cell];
+	  if( !(dirs & (1 << i)) || (distance <= 0) )
+	    continue;
+
+	  Position nextPos;
+	  nextPos.x = node.cell / a_mazeMap.cols + distance * JUMP_DROW[i];
+	  nextPos.y = node.cell % a_mazeMap.cols + distance * JUMP_DCOL[i];
+
+	  int next = mazeMapIndex(a_mazeMap, nextPos.x, nextPos.y);
+	  int nextG = node.g + distance;
+
+	  if( (gScore[next] == -1) || (nextG < gScore[next]) )
+	    {
+	      gScore[next] = nextG;
+	      parent[next] = node.cell;
+	      arrivals[next] = (1 << i);
+	    }
+	  else if( (nextG == gScore[next]) && !(arrivals[next] & (1 << i)) )
+	    {
+	      // As cheap from another direction: expand it again for the
+	      // jumps this direction allows
+	      arrivals[next] |= (1 << i);
+	    }
+	  else
+	    continue;
+
+	  JumpNode nextNode;
+	  nextNode.cell = next;
+	  nextNode.g = nextG;
+	  long long f = nextG + estimateMovesLeft(a_heuristic, nextPos,
+						  a_dragons);
+	  nextNode.key = (f << 31) - nextG;
+	  openSet.addQueue(nextNode);
+	}
+    }
+
+  return result;
+}
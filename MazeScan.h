@@ -0,0 +1,65 @@
+/* ------------------------------------------------------------------------- *
+ *
+ * Filename : MazeScan.h
+ * Version  : 1.0
+ *
+ * Purpose  : Declares the load-time sweep over a maze map's tiles that
+ *          : builds its passability bitmap and locates the entrance and
+ *          : the dragon.
+ *
+ * ------------------------------------------------------------------------- */
+
+#ifndef H_MazeScan
+#define H_MazeScan
+
+#include <vector>
+
+#include "MazeApp.h"
+#include "Queue.h"
+
+using namespace std;
+
+
+//-----------------------------------------------------------------------------
+// Function signatures
+//-----------------------------------------------------------------------------
+
+void scanMazeMap(MazeMap& a_mazeMap);
+  /* Purpose : Builds the passability bitmap of a maze map and finds its
+   *         : first 'e' and first 'd' (in row-major order), all in one
+   *         : sweep over the tiles
+   * Arguments -
+   *   MazeMap& a_mazeMap : Reference to a MazeMap whose tiles are loaded
+   * Postconditions : openBits, openWords, hasEntrance, entrancePos,
+   *                : hasDragon, dragonPos and dragonCount will be set
+   */
+
+void listMazeMapTiles(MazeMap& a_mazeMap, char a_tile,
+		      vector<Position>& a_positions);
+  /* Purpose : Finds every tile of a kind (such as every 'e' or every 'd')
+   * Arguments -
+   *   MazeMap& a_mazeMap : Reference to a MazeMap
+   *   char a_tile : Tile to look for
+   *   vector<Position>& a_positions : Receives the positions, in row-major
+   *                                 : order
+   */
+
+unsigned long long hashMazeMap(MazeMap& a_mazeMap);
+  /* Purpose : Works out a hash of a maze's size and tiles, so saved results
+   *         : can be matched to the maze they came from
+   * Arguments -
+   *   MazeMap& a_mazeMap : Reference to a MazeMap
+   * Returns : 64-bit FNV-1a hash
+   */
+
+bool dragonIsReachable(MazeMap& a_mazeMap, Position a_entrancePos);
+  /* Purpose : Finds out whether any dragon can be reached from the
+   *         : entrance, by flood-filling the passability bitmap a row of
+   *         : 64-bit words at a time
+   * Arguments -
+   *   MazeMap& a_mazeMap : Reference to a scanned MazeMap
+   *   Position a_entrancePos : Position to fill from
+   * Returns : Whether a dragon is reachable
+   */
+
+#endif
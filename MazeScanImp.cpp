@@ -0,0 +1,482 @@
+/* ------------------------------------------------------------------------- *
+ *
+ * Filename : MazeScanImp.cpp
+ * Version  : 1.0
+ *
+ * Purpose  : Implementation of the load-time sweep over a maze map.  Tiles
+ *          : are classified 32 at a time with AVX2 or 16 at a time with
+ *          : SSE2 when the compiler targets them (SSE2 always does on
+ *          : x86-64), and one at a time otherwise.
+ *
+ * ------------------------------------------------------------------------- */
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include <climits>
+#include <string.h>
+
+#include "MazeScan.h"
+
+
+//-----------------------------------------------------------------------------
+// Helper functions
+//-----------------------------------------------------------------------------
+
+/*
+ * Purpose : Records the first entrance and dragon found in a run of tiles
+ * Arguments -
+ *   MazeMap& a_mazeMap : Reference to a MazeMap
+ *   int a_row : Row of the tiles
+ *   int a_col : Column of the first tile of the run
+ *   unsigned int a_entranceMask : Bit i set if tile a_col+i is 'e'
+ *   unsigned int a_dragonMask : Bit i set if tile a_col+i is 'd'
+ */
+static void noteLandmarks(MazeMap& a_mazeMap, int a_row, int a_col,
+			  unsigned int a_entranceMask,
+			  unsigned int a_dragonMask)
+{
+  if( (a_entranceMask != 0) && !(a_mazeMap.hasEntrance) )
+    {
+      a_mazeMap.hasEntrance = true;
+      a_mazeMap.entrancePos.x = a_row;
+      a_mazeMap.entrancePos.y = a_col + __builtin_ctz(a_entranceMask);
+    }
+
+  if( (a_dragonMask != 0) && !(a_mazeMap.hasDragon) )
+    {
+      a_mazeMap.hasDragon = true;
+      a_mazeMap.dragonPos.x = a_row;
+      a_mazeMap.dragonPos.y = a_col + __builtin_ctz(a_dragonMask);
+    }
+
+  a_mazeMap.dragonCount += __builtin_popcount(a_dragonMask);
+}
+
+/*
+ * Purpose : Classifies as many whole vector-widths of a row as fit
+ * Arguments -
+ *   MazeMap& a_mazeMap : Reference to a MazeMap
+ *   int a_row : Row to classify
+ *   unsigned long long* a_bits : The row's words of the bitmap
+ * Returns : Column of the first tile left for the scalar loop
+ */
+static int scanRowVector(MazeMap& a_mazeMap, int a_row,
+			 unsigned long long* a_bits)
+{
+  const char* tiles = &mazeMapCell(a_mazeMap, a_row, 0);
+  int col = 0;
+
+#if defined(__AVX2__)
+  const __m256i space = _mm256_set1_epi8(' ');
+  const __m256i dragon = _mm256_set1_epi8('d');
+  const __m256i entrance = _mm256_set1_epi8('e');
+
+  for( ; col + 32 <= a_mazeMap.cols; col += 32)
+    {
+      __m256i chunk = _mm256_loadu_si256((const __m256i*)(tiles + col));
+      unsigned int dragons =
+	_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, dragon));
+      unsigned int open =
+	_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, space)) | dragons;
+      unsigned int entrances =
+	_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, entrance));
+
+      a_bits[col >> 6] |= (unsigned long long)open << (col & 63);
+
+      if( (entrances | dragons) != 0 )
+	noteLandmarks(a_mazeMap, a_row, col, entrances, dragons);
+    }
+#elif defined(__SSE2__)
+  const __m128i space = _mm_set1_epi8(' ');
+  const __m128i dragon = _mm_set1_epi8('d');
+  const __m128i entrance = _mm_set1_epi8('e');
+
+  for( ; col + 16 <= a_mazeMap.cols; col += 16)
+    {
+      __m128i chunk = _mm_loadu_si128((const __m128i*)(tiles + col));
+      unsigned int dragons = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, dragon));
+      unsigned int open =
+	_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, space)) | dragons;
+      unsigned int entrances =
+	_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, entrance));
+
+      a_bits[col >> 6] |= (unsigned long long)open << (col & 63);
+
+      if( (entrances | dragons) != 0 )
+	noteLandmarks(a_mazeMap, a_row, col, entrances, dragons);
+    }
+#endif
+
+  return col;
+}
+
+/*
+ * Purpose : Widens a span of words to take in one more
+ * Arguments -
+ *   int& a_first : First word of the span (INT_MAX if empty)
+ *   int& a_last : Last word of the span (-1 if empty)
+ *   int a_word : Word to take in
+ */
+static void widenSpan(int& a_first, int& a_last, int a_word)
+{
+  if(a_word < a_first)
+    a_first = a_word;
+  if(a_word > a_last)
+    a_last = a_word;
+}
+
+/*
+ * Purpose : Spreads newly reached cells along a row to the ends of the open
+ *         : runs they are in.  Toward higher columns this is an add (a
+ *         : seed's carry ripples to the end of its run); toward lower
+ *         : columns a shift-and-mask fill that doubles its reach each step.
+ *         : Runs that carry on past the words given are followed.
+ * Arguments -
+ *   unsigned long long* a_reach : The row's reached words (all open)
+ *   const unsigned long long* a_open : The row's passability words
+ *   int a_words : Words per row
+ *   int a_first : First word with new cells
+ *   int a_last : Last word with new cells
+ *   int& a_changedFirst : Widened to take in every word changed
+ *   int& a_changedLast : (as above)
+ */
+static void fillRow(unsigned long long* a_reach,
+		    const unsigned long long* a_open, int a_words,
+		    int a_first, int a_last, int& a_changedFirst,
+		    int& a_changedLast)
+{
+  unsigned long long carry = 0;
+  int w;
+
+  for(w = a_first; (w < a_words) && ((w <= a_last) || (carry != 0)); w++)
+    {
+      unsigned long long open = a_open[w];
+      unsigned long long seeds = a_reach[w];
+      unsigned long long sum;
+      unsigned long long carryOut =
+	__builtin_add_overflow(open, seeds, &sum);
+      carryOut |= __builtin_add_overflow(sum, carry, &sum);
+
+      a_reach[w] = open & ((sum ^ open) | seeds);
+      if(a_reach[w] != seeds)
+	widenSpan(a_changedFirst, a_changedLast, w);
+
+      carry = carryOut;
+    }
+
+  for(w = w - 1; w >= 0; w--)
+    {
+      unsigned long long open = a_open[w];
+      unsigned long long reach = a_reach[w];
+      unsigned long long before = reach;
+
+      // Carry in from the lowest column of the next word (past the first
+      // word given, only while a run carries on down)
+      if( (w + 1 < a_words) && (a_reach[w + 1] & 1) )
+	reach |= open & (1ULL << 63);
+      if( (w < a_first) && (reach == before) )
+	break;
+
+      reach |= open & (reach >> 1);
+      open &= open >> 1;
+      reach |= open & (reach >> 2);
+      open &= open >> 2;
+      reach |= open & (reach >> 4);
+      open &= open >> 4;
+      reach |= open & (reach >> 8);
+      open &= open >> 8;
+      reach |= open & (reach >> 16);
+      open &= open >> 16;
+      reach |= open & (reach >> 32);
+
+      a_reach[w] = reach;
+      if(reach != before)
+	widenSpan(a_changedFirst, a_changedLast, w);
+    }
+}
+
+/*
+ * Purpose : Queues a row of a flood fill to take in new cells from a span
+ *         : of words of the rows around it
+ * Arguments -
+ *   Queue<int>& a_dirtyRows : Rows waiting to be filled
+ *   int* a_dirtyFirst : First dirty word of each queued row
+ *   int* a_dirtyLast : Last dirty word of each queued row (-1 if the row
+ *                    : isn't queued)
+ *   int a_rows : Number of rows
+ *   int a_row : Row to queue (may be out of range)
+ *   int a_first : First word of the span
+ *   int a_last : Last word of the span
+ */
+static void queueRow(Queue<int>& a_dirtyRows, int* a_dirtyFirst,
+		     int* a_dirtyLast, int a_rows, int a_row, int a_first,
+		     int a_last)
+{
+  if( (a_row < 0) || (a_row >= a_rows) )
+    return;
+
+  if(a_dirtyLast[a_row] < 0)
+    {
+      a_dirtyFirst[a_row] = a_first;
+      a_dirtyLast[a_row] = a_last;
+      a_dirtyRows.addQueue(a_row);
+    }
+  else
+    {
+      widenSpan(a_dirtyFirst[a_row], a_dirtyLast[a_row], a_first);
+      widenSpan(a_dirtyFirst[a_row], a_dirtyLast[a_row], a_last);
+    }
+}
+
+/*
+ * Purpose : Checks a reached-cell bitmap for any dragon
+ * Arguments -
+ *   MazeMap& a_mazeMap : Reference to a MazeMap
+ *   unsigned long long* a_reach : Reached cells
+ * Returns : Whether a reached cell holds a dragon
+ */
+static bool reachesDragon(MazeMap& a_mazeMap, unsigned long long* a_reach)
+{
+  if(a_mazeMap.dragonCount == 1)
+    {
+      int row = a_mazeMap.dragonPos.x;
+      int col = a_mazeMap.dragonPos.y;
+      return (a_reach[(long)row * a_mazeMap.openWords + (col >> 6)] >>
+	      (col & 63)) & 1;
+    }
+
+  for(int row = 0; row < a_mazeMap.rows; row++)
+    {
+      for(int w = 0; w < a_mazeMap.openWords; w++)
+	{
+	  unsigned long long bits =
+	    a_reach[(long)row * a_mazeMap.openWords + w];
+
+	  while(bits != 0)
+	    {
+	      int col = w * 64 + __builtin_ctzll(bits);
+	      bits &= bits - 1;
+
+	      if(mazeMapCell(a_mazeMap, row, col) == 'd')
+		return true;
+	    }
+	}
+    }
+
+  return false;
+}
+
+
+//-----------------------------------------------------------------------------
+// Program functions
+//-----------------------------------------------------------------------------
+
+/*
+ * Purpose : Builds the passability bitmap of a maze map and finds its first
+ *         : 'e' and first 'd' (in row-major order), all in one sweep over
+ *         : the tiles
+ * Arguments -
+ *   MazeMap& a_mazeMap : Reference to a MazeMap whose tiles are loaded
+ * Postconditions : openBits, openWords, hasEntrance, entrancePos,
+ *                : hasDragon and dragonPos will be set
+ */
+void scanMazeMap(MazeMap& a_mazeMap)
+{
+  a_mazeMap.openWords = (a_mazeMap.cols + 63) / 64;
+  a_mazeMap.openBits =
+    new unsigned long long[(long)a_mazeMap.rows * a_mazeMap.openWords]();
+  a_mazeMap.hasEntrance = false;
+  a_mazeMap.hasDragon = false;
+  a_mazeMap.dragonCount = 0;
+
+  for(int row = 0; row < a_mazeMap.rows; row++)
+    {
+      unsigned long long* bits =
+	a_mazeMap.openBits + (long)row * a_mazeMap.openWords;
+
+      // Tiles past the last whole vector (or all of them, without SIMD)
+      for(int col = scanRowVector(a_mazeMap, row, bits);
+	  col < a_mazeMap.cols; col++)
+	{
+	  char tile = mazeMapCell(a_mazeMap, row, col);
+
+	  if( (tile == ' ') || (tile == 'd') )
+	    bits[col >> 6] |= 1ULL << (col & 63);
+
+	  if( (tile == 'e') || (tile == 'd') )
+	    noteLandmarks(a_mazeMap, row, col, (tile == 'e'), (tile == 'd'));
+	}
+    }
+}
+
+/*
+ * Purpose : Finds every tile of a kind (such as every 'e' or every 'd')
+ * Arguments -
+ *   MazeMap& a_mazeMap : Reference to a MazeMap
+ *   char a_tile : Tile to look for
+ *   vector<Position>& a_positions : Receives the positions, in row-major
+ *                                 : order
+ */
+void listMazeMapTiles(MazeMap& a_mazeMap, char a_tile,
+		      vector<Position>& a_positions)
+{
+  a_positions.clear();
+
+  for(int row = 0; row < a_mazeMap.rows; row++)
+    {
+      const char* rowStart = &mazeMapCell(a_mazeMap, row, 0);
+      const char* rowEnd = rowStart + a_mazeMap.cols;
+      const char* tile = rowStart;
+
+      while( (tile = (const char*)memchr(tile, a_tile, rowEnd - tile)) !=
+	     NULL )
+	{
+	  Position pos;
+	  pos.x = row;
+	  pos.y = tile - rowStart;
+	  a_positions.push_back(pos);
+	  tile++;
+	}
+    }
+}
+
+/*
+ * Purpose : Works out a hash of a maze's size and tiles, so saved results
+ *         : can be matched to the maze they came from
+ * Arguments -
+ *   MazeMap& a_mazeMap : Reference to a MazeMap
+ * Returns : 64-bit FNV-1a hash
+ */
+unsigned long long hashMazeMap(MazeMap& a_mazeMap)
+{
+  const unsigned long long FNV_PRIME = 1099511628211ULL;
+  unsigned long long hash = 14695981039346656037ULL;
+
+  hash = (hash ^ (unsigned long long)a_mazeMap.rows) * FNV_PRIME;
+  hash = (hash ^ (unsigned long long)a_mazeMap.cols) * FNV_PRIME;
+
+  for(int row = 0; row < a_mazeMap.rows; row++)
+    {
+      const unsigned char* tile =
+	(const unsigned char*)&mazeMapCell(a_mazeMap, row, 0);
+
+      for(int col = 0; col < a_mazeMap.cols; col++)
+	hash = (hash ^ tile[col]) * FNV_PRIME;
+    }
+
+  return hash;
+}
+
+/*
+ * Purpose : Finds out whether any dragon can be reached from the entrance,
+ *         : by flood-filling the passability bitmap a row of 64-bit words
+ *         : at a time.  When a row's reached cells grow, the rows above
+ *         : and below are queued to take in the words that grew; this goes
+ *         : on until nothing changes (or, with one dragon, until it is
+ *         : reached).
+ * Arguments -
+ *   MazeMap& a_mazeMap : Reference to a scanned MazeMap
+ *   Position a_entrancePos : Position to fill from
+ * Returns : Whether a dragon is reachable
+ */
+bool dragonIsReachable(MazeMap& a_mazeMap, Position a_entrancePos)
+{
+  if(a_mazeMap.dragonCount == 0)
+    return false;
+
+  int rows = a_mazeMap.rows;
+  int words = a_mazeMap.openWords;
+  unsigned long long* reach = new unsigned long long[(long)rows * words]();
+  int* dirtyFirst = new int[rows];
+  int* dirtyLast = new int[rows];
+  Queue<int> dirtyRows(64);
+
+  for(int row = 0; row < rows; row++)
+    dirtyLast[row] = -1;
+
+  // Seed with the open cells next to the entrance (which isn't open
+  // itself), and queue their rows and the rows around them
+  const int seedRow[4] = { 0, -1, 0, 1 };
+  const int seedCol[4] = { 1, 0, -1, 0 };
+
+  for(int dir = 0; dir < 4; dir++)
+    {
+      int row = a_entrancePos.x + seedRow[dir];
+      int col = a_entrancePos.y + seedCol[dir];
+
+      if( !(mazeMapIsOpen(a_mazeMap, row, col)) )
+	continue;
+
+      reach[(long)row * words + (col >> 6)] |= 1ULL << (col & 63);
+
+      for(int r = row - 1; r <= row + 1; r++)
+	queueRow(dirtyRows, dirtyFirst, dirtyLast, rows, r, col >> 6,
+		 col >> 6);
+    }
+
+  // (A dragon may be right next to the entrance)
+  bool found = (a_mazeMap.dragonCount == 1) &&
+    reachesDragon(a_mazeMap, reach);
+
+  while( !found && !(dirtyRows.isEmptyQueue()) )
+    {
+      int row = dirtyRows.front();
+      dirtyRows.deleteQueue();
+
+      int first = dirtyFirst[row];
+      int last = dirtyLast[row];
+      dirtyLast[row] = -1;
+
+      unsigned long long* rowReach = reach + (long)row * words;
+      const unsigned long long* rowOpen =
+	a_mazeMap.openBits + (long)row * words;
+      int changedFirst = INT_MAX;
+      int changedLast = -1;
+
+      // Step in from the rows above and below...
+      for(int w = first; w <= last; w++)
+	{
+	  unsigned long long fromNeighbours = 0;
+	  if(row > 0)
+	    fromNeighbours |= rowReach[w - words];
+	  if(row + 1 < rows)
+	    fromNeighbours |= rowReach[w + words];
+
+	  unsigned long long grown = fromNeighbours & rowOpen[w] & ~rowReach[w];
+	  if(grown != 0)
+	    {
+	      rowReach[w] |= grown;
+	      widenSpan(changedFirst, changedLast, w);
+	    }
+	}
+
+      // ...then along the row
+      fillRow(rowReach, rowOpen, words, first, last, changedFirst,
+	      changedLast);
+
+      if(changedLast < 0)
+	continue;
+
+      if( (a_mazeMap.dragonCount == 1) && (row == a_mazeMap.dragonPos.x) )
+	found = reachesDragon(a_mazeMap, reach);
+
+      queueRow(dirtyRows, dirtyFirst, dirtyLast, rows, row - 1,
+	       changedFirst, changedLast);
+      queueRow(dirtyRows, dirtyFirst, dirtyLast, rows, row + 1,
+	       changedFirst, changedLast);
+    }
+
+  // With several dragons, look for any of them in what was reached
+  if( !found && (a_mazeMap.dragonCount > 1) )
+    found = reachesDragon(a_mazeMap, reach);
+
+  delete [] reach;
+  delete [] dirtyFirst;
+  delete [] dirtyLast;
+
+  return found;
+}
@@ -0,0 +1,219 @@
+/* ------------------------------------------------------------------------- *
+ *
+ * Filename : MazeSearch.h
+ * Version  : 1.0
+ *
+ * Purpose  : Declares the shortest-path search engines that can be used in
+ *          : place of the depth-first search in MazeApp.cpp.
+ *
+ * ------------------------------------------------------------------------- */
+
+#ifndef H_MazeSearch
+#define H_MazeSearch
+
+#include <vector>
+
+#include "MazeApp.h"
+
+using namespace std;
+
+
+//-----------------------------------------------------------------------------
+// "Support" structures (meaning, that they help make code pretty)
+//-----------------------------------------------------------------------------
+
+// Name: SearchEngine
+// Purpose: Names the search used to solve a maze
+enum SearchEngine
+{
+  ENGINE_DFS,   // depth-first search with backtracking (the original)
+  ENGINE_BFS,   // breadth-first search
+  ENGINE_ASTAR, // A* search
+  ENGINE_PARALLEL_BFS, // breadth-first search spread over threads
+  ENGINE_BIDIRECTIONAL, // breadth-first search from both ends at once
+  ENGINE_JUNCTIONS, // search of the junction graph (see MazeGraph.h)
+  ENGINE_MULTI_SOURCE, // breadth-first search from every entrance at once
+  ENGINE_IDASTAR, // IDA* search, in a fixed amount of memory
+  ENGINE_JUMP_POINTS // jump point search (see MazeJump.h)
+};
+
+// Name: MazeHeuristic
+// Purpose: Estimates the number of moves from a cell to the goal.  Must
+//        : never overestimate, or A* may return a longer path.
+typedef int (*MazeHeuristic)(Position a_cell, Position a_goal);
+
+// The solution cache (declared in MazeCache.h, which includes this file)
+struct MazeCache;
+
+// Name: MazeSearchOptions
+// Purpose: Stores how a maze should be searched (set from the command line)
+struct MazeSearchOptions
+{
+  /** Search engine to use **/
+  SearchEngine engine;
+
+  /** Heuristic for ENGINE_ASTAR, ENGINE_IDASTAR and ENGINE_JUMP_POINTS,
+      and the name it was looked up by (see findHeuristic()) **/
+  MazeHeuristic heuristic;
+  string heuristicName;
+
+  /** Threads for ENGINE_PARALLEL_BFS (0 means one per core) **/
+  int threadCount;
+
+  /** Bytes ENGINE_IDASTAR may use (0 for no limit) **/
+  long long maxMemory;
+
+  /** Check that a dragon is reachable before searching? **/
+  bool precheck;
+
+  /** Report the solve's counters (see MazeStats.h) when it is done? **/
+  bool collectStats;
+
+  /** Solutions remembered so far (see MazeCache.h), or NULL **/
+  MazeCache* cache;
+};
+
+// Name: MazeSearchResult
+// Purpose: Stores the outcome of a search engine run
+struct MazeSearchResult
+{
+  /** Was the dragon reached? **/
+  bool foundDragon;
+
+  /** Moves from the entrance to the dragon **/
+  PackedPath path;
+
+  /** Number of cells expanded (taken off the frontier) **/
+  long expanded;
+};
+
+// Name: DragonRoute
+// Purpose: Stores the route to one dragon found by a multi-source search
+struct DragonRoute
+{
+  /** Where the dragon is **/
+  Position dragon;
+
+  /** Can any entrance reach it? **/
+  bool reached;
+
+  /** Moves from the nearest entrance (the path's start) to the dragon **/
+  PackedPath path;
+};
+
+
+//-----------------------------------------------------------------------------
+// Function signatures
+//-----------------------------------------------------------------------------
+
+MazeSearchResult solveMazeBFS(MazeMap& a_mazeMap, Position a_entrancePos);
+  /* Purpose : Finds a shortest path from the entrance to the dragon using
+   *         : breadth-first search
+   * Arguments -
+   *   MazeMap& a_mazeMap : Reference to a MazeMap
+   *   Position a_entrancePos : Position to start searching from
+   * Returns : The search outcome
+   */
+
+MazeSearchResult solveMazeBidirectional(MazeMap& a_mazeMap,
+					Position a_entrancePos,
+					vector<Position>& a_dragons);
+  /* Purpose : Finds a shortest path from the entrance to the nearest
+   *         : dragon using breadth-first searches from both ends that
+   *         : stop when they meet
+   * Arguments -
+   *   MazeMap& a_mazeMap : Reference to a MazeMap
+   *   Position a_entrancePos : Position to start searching from
+   *   vector<Position>& a_dragons : Positions of the dragons
+   * Returns : The search outcome
+   */
+
+long solveMazeMultiSource(MazeMap& a_mazeMap, vector<Position>& a_entrances,
+			  vector<DragonRoute>& a_routes);
+  /* Purpose : Finds, for every dragon, a shortest path from the nearest
+   *         : entrance, with one breadth-first search from all entrances
+   * Arguments -
+   *   MazeMap& a_mazeMap : Reference to a MazeMap
+   *   vector<Position>& a_entrances : Positions of the entrances
+   *   vector<DragonRoute>& a_routes : One per dragon, with its position
+   *                                 : set; receives the routes
+   * Returns : Number of cells expanded
+   */
+
+MazeSearchResult solveMazeParallelBFS(MazeMap& a_mazeMap,
+				      Position a_entrancePos,
+				      int a_threadCount);
+  /* Purpose : Finds a shortest path from the entrance to the dragon using
+   *         : a level-synchronous breadth-first search whose levels are
+   *         : split across threads
+   * Arguments -
+   *   MazeMap& a_mazeMap : Reference to a MazeMap
+   *   Position a_entrancePos : Position to start searching from
+   *   int a_threadCount : Threads to search on (0 means one per core)
+   * Returns : The search outcome
+   */
+
+MazeSearchResult solveMazeAStar(MazeMap& a_mazeMap, Position a_entrancePos,
+				vector<Position>& a_dragons,
+				MazeHeuristic a_heuristic);
+  /* Purpose : Finds a shortest path from the entrance to the nearest
+   *         : dragon using A* search
+   * Arguments -
+   *   MazeMap& a_mazeMap : Reference to a MazeMap
+   *   Position a_entrancePos : Position to start searching from
+   *   vector<Position>& a_dragons : Positions of every dragon (the goals)
+   *   MazeHeuristic a_heuristic : Estimate of the moves left to a goal
+   * Returns : The search outcome
+   */
+
+MazeSearchResult solveMazeIDAStar(MazeMap& a_mazeMap, Position a_entrancePos,
+				  vector<Position>& a_dragons,
+				  MazeHeuristic a_heuristic,
+				  long long a_maxMemory,
+				  bool& a_hitMemoryLimit);
+  /* Purpose : Finds a shortest path from the entrance to the nearest
+   *         : dragon using IDA* search (repeated depth-first searches with a rising
+   *         : limit on g + h), holding only the current path and a table
+   *         : of costs that fit in a fixed amount of memory
+   * Arguments -
+   *   MazeMap& a_mazeMap : Reference to a MazeMap
+   *   Position a_entrancePos : Position to start searching from
+   *   vector<Position>& a_dragons : Positions of every dragon (the goals)
+   *   MazeHeuristic a_heuristic : Estimate of the moves left to a goal
+   *   long long a_maxMemory : Bytes the search may use (0 for no limit)
+   *   bool& a_hitMemoryLimit : Set if some path was too long to hold in
+   *                          : a_maxMemory; the path found (if any) may
+   *                          : then not be a shortest one
+   * Returns : The search outcome
+   */
+
+int estimateMovesLeft(MazeHeuristic a_heuristic, Position a_cell,
+		      vector<Position>& a_goals);
+  /* Purpose : Estimates the moves from a cell to the nearest of several
+   *         : goals (the least of the heuristic's estimates, so it never
+   *         : overestimates when the heuristic doesn't)
+   * Arguments -
+   *   MazeHeuristic a_heuristic : Estimate of the moves left to one goal
+   *   Position a_cell : Position to estimate from
+   *   vector<Position>& a_goals : Positions of the goals
+   * Returns : The least estimate (0 if there are no goals)
+   */
+
+int manhattanHeuristic(Position a_cell, Position a_goal);
+  /* Purpose : Estimates moves left as the Manhattan (taxicab) distance
+   * Returns : |dx| + |dy|
+   */
+
+int zeroHeuristic(Position a_cell, Position a_goal);
+  /* Purpose : Estimates no moves left, which turns A* into Dijkstra's search
+   * Returns : 0
+   */
+
+MazeHeuristic findHeuristic(string a_name);
+  /* Purpose : Looks up a heuristic by name ("manhattan" or "zero")
+   * Arguments -
+   *   string a_name : Name of the heuristic
+   * Returns : The heuristic, or NULL if the name is unknown
+   */
+
+#endif
@@ -0,0 +1,1151 @@
+/* ------------------------------------------------------------------------- *
+ *
+ * Filename : MazeSearchImp.cpp
+ * Version  : 1.0
+ *
+ * Purpose  : Implementation of the shortest-path search engines
+ *
+ * ------------------------------------------------------------------------- */
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <vector>
+#include <ctype.h>
+#include <stdlib.h>
+
+#include "MazeSearch.h"
+#include "PriorityQueue.h"
+#include "Queue.h"
+#include "ThreadPool.h"
+
+
+//-----------------------------------------------------------------------------
+// Globals
+//-----------------------------------------------------------------------------
+
+/** Directions in the order neighbours are expanded, with their offsets **/
+const char SEARCH_DIRS[4] = { EAST, NORTH, WEST, SOUTH };
+const int SEARCH_DROW[4] = { 0, -1, 0, 1 };
+const int SEARCH_DCOL[4] = { 1, 0, -1, 0 };
+
+/** Marks the start cell in a parent-direction grid **/
+const unsigned char START_MARK = 'X';
+
+/** Marks the dragon in a bidirectional search, whose backward half keeps
+    its directions in lower case ('e', 'n', 'w', 's') **/
+const unsigned char GOAL_MARK = 'x';
+
+/** Parallel BFS: frontiers smaller than this are expanded on one thread,
+    and tasks per thread (so a slow task doesn't hold up a level) **/
+const int PARALLEL_BFS_MIN_FRONTIER = 1024;
+const int PARALLEL_BFS_TASKS_PER_THREAD = 4;
+
+/** Parallel BFS: switch to bottom-up once the frontier is more than
+    1/ALPHA of the unreached cells, and back to top-down once it is less
+    than 1/BETA of all open cells **/
+const int PARALLEL_BFS_ALPHA = 14;
+const int PARALLEL_BFS_BETA = 24;
+
+/** IDA*: the first threshold raise, doubled after every iteration **/
+const long long IDASTAR_FIRST_RAISE = 2;
+
+
+//-----------------------------------------------------------------------------
+// "Support" structures
+//-----------------------------------------------------------------------------
+
+// Name: AStarNode
+// Purpose: An entry on the A* open set.  Ordered by f = g + h, with ties
+//        : going to the larger g (the node nearer the goal), which keeps
+//        : A* from fanning out across open rooms.
+struct AStarNode
+{
+  /** Sort key: (f << 31) - g **/
+  long long key;
+
+  /** Cell index and its cost from the start when pushed **/
+  int cell;
+  int g;
+
+  bool operator<(const AStarNode& other) const
+  {
+    return key < other.key;
+  }
+};
+
+// Name: IDAStarFrame
+// Purpose: One cell of the path held by the IDA* search
+struct IDAStarFrame
+{
+  /** Cell index **/
+  int cell;
+
+  /** Index (into SEARCH_DIRS) of the next neighbour to try **/
+  unsigned char nextDir;
+};
+
+// Name: IDAStarEntry
+// Purpose: A slot of the IDA* table of the cheapest cost each cell has
+//        : been reached at.  When the table is smaller than the maze,
+//        : cells share slots and the latest one wins.
+struct IDAStarEntry
+{
+  /** Cell index (-1 for an empty slot) **/
+  int cell;
+  int g;
+
+  /** Iteration the cost was found in **/
+  int iteration;
+};
+
+// Name: ParallelBFSState
+// Purpose: What the tasks of one parallel BFS level share.  Cells keep a
+//        : level code instead of a parent direction: 0 for "not reached",
+//        : otherwise 1 + (level mod 3).  Neighbouring cells are at most
+//        : one level apart, so that is enough to walk back to the start,
+//        : and every thread that reaches a cell writes the same code.
+struct ParallelBFSState
+{
+  MazeMap* mazeMap;
+  atomic<unsigned char>* levels;
+  int cellCount;
+
+  /** Level of the frontier being expanded **/
+  int level;
+
+  /** Frontier, in parts; part p holds frontier[offsets[p]...] **/
+  vector<int>* frontier;
+  vector<int> offsets;
+  int frontierSize;
+
+  /** Next frontier, one part per task **/
+  vector<int>* next;
+  int taskCount;
+
+  /** Lowest index of a dragon reached (INT_MAX if none yet) **/
+  atomic<int> dragonCell;
+
+  /** Open cells counted by each task of the first pass **/
+  vector<int> openCounts;
+};
+
+
+//-----------------------------------------------------------------------------
+// Helper functions
+//-----------------------------------------------------------------------------
+
+/*
+ * Purpose : Steps from a cell back against the direction it was reached in
+ * Arguments -
+ *   MazeMap& a_mazeMap : Reference to a MazeMap
+ *   int a_cell : Index of the cell
+ *   char a_dir : Direction the cell was reached in
+ * Returns : Index of the cell it was reached from
+ */
+static int stepBack(MazeMap& a_mazeMap, int a_cell, char a_dir)
+{
+  if(a_dir == EAST)
+    return a_cell - 1;
+  else if(a_dir == NORTH)
+    return a_cell + a_mazeMap.cols;
+  else if(a_dir == WEST)
+    return a_cell + 1;
+  else
+    return a_cell - a_mazeMap.cols;
+}
+
+/*
+ * Purpose : Walks a parent-direction grid back from a cell to the start and
+ *         : packs the moves in forward order
+ * Arguments -
+ *   MazeMap& a_mazeMap : Reference to a MazeMap
+ *   unsigned char* a_parentDir : Direction used to reach each cell
+ *   int a_cell : Index of the cell to walk back from
+ *   PackedPath& a_path : Receives the moves from the start to the cell
+ */
+static void tracePath(MazeMap& a_mazeMap, unsigned char* a_parentDir,
+		      int a_cell, PackedPath& a_path)
+{
+  // First pass: find the start and the number of moves
+  long length = 0;
+  int cell = a_cell;
+  while(a_parentDir[cell] != START_MARK)
+    {
+      cell = stepBack(a_mazeMap, cell, a_parentDir[cell]);
+      length++;
+    }
+
+  a_path.setStart(cell / a_mazeMap.cols, cell % a_mazeMap.cols);
+  a_path.resize(length);
+
+  // Second pass: fill the moves in from the last one
+  cell = a_cell;
+  while(length > 0)
+    {
+      length--;
+      a_path.setMove(length, a_parentDir[cell]);
+      cell = stepBack(a_mazeMap, cell, a_parentDir[cell]);
+    }
+}
+
+
+/*
+ * Purpose : Gets the direction opposite another
+ * Arguments -
+ *   char a_dir : A direction
+ * Returns : The direction back the way a_dir came
+ */
+static char oppositeDir(char a_dir)
+{
+  if(a_dir == EAST)
+    return WEST;
+  else if(a_dir == NORTH)
+    return SOUTH;
+  else if(a_dir == WEST)
+    return EAST;
+  else
+    return NORTH;
+}
+
+/*
+ * Purpose : Expands one whole level of one half of a bidirectional search.
+ *         : Stops early when a cell of this half touches a cell of the
+ *         : other half.
+ * Arguments -
+ *   MazeMap& a_mazeMap : Reference to a MazeMap
+ *   unsigned char* a_parentDir : Directions of both halves
+ *   Queue<int>& a_frontier : Frontier of this half
+ *   bool a_forward : Is this the half searching from the entrance?
+ *   int& a_meetFrom : Receives the cell of this half where they meet
+ *   int& a_meetDir : Receives the index of the direction to the other half
+ *   long& a_expanded : Incremented for every cell expanded
+ * Returns : Whether the halves met
+ */
+static bool expandLevel(MazeMap& a_mazeMap, unsigned char* a_parentDir,
+			Queue<int>& a_frontier, bool a_forward,
+			int& a_meetFrom, int& a_meetDir, long& a_expanded)
+{
+  for(int levelSize = a_frontier.size(); levelSize > 0; levelSize--)
+    {
+      int cell = a_frontier.front();
+      a_frontier.deleteQueue();
+      a_expanded++;
+
+      int row = cell / a_mazeMap.cols;
+      int col = cell % a_mazeMap.cols;
+
+      for(int i = 0; i < 4; i++)
+	{
+	  int nextRow = row + SEARCH_DROW[i];
+	  int nextCol = col + SEARCH_DCOL[i];
+
+	  if( (nextRow < 0) || (nextRow >= a_mazeMap.rows) ||
+	      (nextCol < 0) || (nextCol >= a_mazeMap.cols) )
+	    continue;
+
+	  int next = mazeMapIndex(a_mazeMap, nextRow, nextCol);
+	  unsigned char mark = a_parentDir[next];
+
+	  // The other half got here first (this also finds its start,
+	  // which may be a tile this half cannot step on, like 'e')
+	  if( (mark != 0) && ((isupper(mark) != 0) != a_forward) )
+	    {
+	      a_meetFrom = cell;
+	      a_meetDir = i;
+	      return true;
+	    }
+
+	  if( (mark == 0) && mazeMapIsOpen(a_mazeMap, nextRow, nextCol) )
+	    {
+	      a_parentDir[next] = a_forward ? SEARCH_DIRS[i] :
+		tolower(SEARCH_DIRS[i]);
+	      a_frontier.addQueue(next);
+	    }
+	}
+    }
+
+  return false;
+}
+
+/*
+ * Purpose : Gets the parallel BFS code for a level
+ * Arguments -
+ *   int a_level : The level (moves from the start)
+ * Returns : 1 + (level mod 3)
+ */
+static unsigned char levelCode(int a_level)
+{
+  return (unsigned char)(1 + a_level % 3);
+}
+
+/*
+ * Purpose : Marks a cell as reached on the next level, unless some thread
+ *         : has reached it already, and adds it to a task's next frontier
+ * Arguments -
+ *   ParallelBFSState* a_state : The search
+ *   int a_cell : Index of the cell
+ *   int a_task : Task that reached it
+ */
+static void claimCell(ParallelBFSState* a_state, int a_cell, int a_task)
+{
+  atomic<unsigned char>& code = a_state->levels[a_cell];
+
+  if( (code.load(memory_order_relaxed) != 0) ||
+      (code.exchange(levelCode(a_state->level + 1),
+		     memory_order_relaxed) != 0) )
+    return;
+
+  a_state->next[a_task].push_back(a_cell);
+
+  if(mazeMapCellAt(*a_state->mazeMap, a_cell) == 'd')
+    {
+      int found = a_state->dragonCell.load();
+      while( (a_cell < found) &&
+	     !(a_state->dragonCell.compare_exchange_weak(found, a_cell)) )
+	;
+    }
+}
+
+/*
+ * Purpose : Parallel BFS task that clears a slice of the level grid and
+ *         : counts the open cells in it
+ * Arguments -
+ *   int a_task : Task number
+ *   void* a_context : The ParallelBFSState
+ */
+static void clearLevelsTask(int a_task, void* a_context)
+{
+  ParallelBFSState* state = (ParallelBFSState*)a_context;
+  MazeMap& mazeMap = *state->mazeMap;
+  int first = (int)((long long)state->cellCount * a_task / state->taskCount);
+  int last = (int)((long long)state->cellCount * (a_task + 1) /
+		   state->taskCount);
+  int open = 0;
+
+  for(int cell = first; cell < last; cell++)
+    {
+      state->levels[cell].store(0, memory_order_relaxed);
+
+      char tile = mazeMapCellAt(mazeMap, cell);
+      if( (tile == ' ') || (tile == 'd') )
+	open++;
+    }
+
+  state->openCounts[a_task] = open;
+}
+
+/*
+ * Purpose : Parallel BFS task that expands a slice of the frontier top-down
+ *         : (each frontier cell claims its unreached neighbours)
+ * Arguments -
+ *   int a_task : Task number
+ *   void* a_context : The ParallelBFSState
+ */
+static void expandTopDownTask(int a_task, void* a_context)
+{
+  ParallelBFSState* state = (ParallelBFSState*)a_context;
+  MazeMap& mazeMap = *state->mazeMap;
+  int first = (int)((long long)state->frontierSize * a_task /
+		    state->taskCount);
+  int last = (int)((long long)state->frontierSize * (a_task + 1) /
+		   state->taskCount);
+
+  // Find the part holding the first cell of the slice
+  int part = 0;
+  while(state->offsets[part + 1] <= first)
+    part++;
+
+  for(int i = first; i < last; i++)
+    {
+      while(state->offsets[part + 1] <= i)
+	part++;
+
+      int cell = state->frontier[part][i - state->offsets[part]];
+      int row = cell / mazeMap.cols;
+      int col = cell % mazeMap.cols;
+
+      for(int dir = 0; dir < 4; dir++)
+	{
+	  int nextRow = row + SEARCH_DROW[dir];
+	  int nextCol = col + SEARCH_DCOL[dir];
+
+	  if( mazeMapIsOpen(mazeMap, nextRow, nextCol) )
+	    claimCell(state, mazeMapIndex(mazeMap, nextRow, nextCol), a_task);
+	}
+    }
+}
+
+/*
+ * Purpose : Parallel BFS task that expands the frontier bottom-up over a
+ *         : slice of the grid (each unreached cell looks for a neighbour
+ *         : on the frontier).  Cheaper than top-down when the frontier
+ *         : covers much of what is left.
+ * Arguments -
+ *   int a_task : Task number
+ *   void* a_context : The ParallelBFSState
+ */
+static void expandBottomUpTask(int a_task, void* a_context)
+{
+  ParallelBFSState* state = (ParallelBFSState*)a_context;
+  MazeMap& mazeMap = *state->mazeMap;
+  int first = (int)((long long)state->cellCount * a_task / state->taskCount);
+  int last = (int)((long long)state->cellCount * (a_task + 1) /
+		   state->taskCount);
+  unsigned char frontierCode = levelCode(state->level);
+
+  int row = first / mazeMap.cols;
+  int col = first % mazeMap.cols;
+
+  for(int cell = first; cell < last; cell++)
+    {
+      if( (state->levels[cell].load(memory_order_relaxed) == 0) &&
+	  mazeMapIsOpen(mazeMap, row, col) )
+	{
+	  for(int dir = 0; dir < 4; dir++)
+	    {
+	      int prevRow = row - SEARCH_DROW[dir];
+	      int prevCol = col - SEARCH_DCOL[dir];
+
+	      if( (prevRow >= 0) && (prevRow < mazeMap.rows) &&
+		  (prevCol >= 0) && (prevCol < mazeMap.cols) &&
+		  (state->levels[mazeMapIndex(mazeMap, prevRow, prevCol)]
+		   .load(memory_order_relaxed) == frontierCode) )
+		{
+		  claimCell(state, cell, a_task);
+		  break;
+		}
+	    }
+	}
+
+      if(++col == mazeMap.cols)
+	{
+	  col = 0;
+	  row++;
+	}
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// Search engines
+//-----------------------------------------------------------------------------
+
+/*
+ * Purpose : Finds a shortest path from the entrance to the dragon using
+ *         : breadth-first search.  The frontier is a ring buffer of cell
+ *         : indices and each cell keeps one byte (the direction it was
+ *         : reached from), so memory stays at about one byte per cell.
+ * Arguments -
+ *   MazeMap& a_mazeMap : Reference to a MazeMap
+ *   Position a_entrancePos : Position to start searching from
+ * Returns : The search outcome
+ */
+MazeSearchResult solveMazeBFS(MazeMap& a_mazeMap, Position a_entrancePos)
+{
+  MazeSearchResult result;
+  result.foundDragon = false;
+  result.expanded = 0;
+
+  // 0 means "not reached yet"
+  unsigned char* parentDir =
+    new unsigned char[a_mazeMap.rows * a_mazeMap.cols]();
+
+  // The frontier of a grid is rarely wider than its perimeter
+  Queue<int> frontier(2 * (a_mazeMap.rows + a_mazeMap.cols));
+
+  int start = mazeMapIndex(a_mazeMap, a_entrancePos.x, a_entrancePos.y);
+  parentDir[start] = START_MARK;
+  frontier.addQueue(start);
+
+  while( !(frontier.isEmptyQueue()) )
+    {
+      int cell = frontier.front();
+      frontier.deleteQueue();
+      result.expanded++;
+
+      if(mazeMapCellAt(a_mazeMap, cell) == 'd')
+	{
+	  result.foundDragon = true;
+	  tracePath(a_mazeMap, parentDir, cell, result.path);
+	  break;
+	}
+
+      int row = cell / a_mazeMap.cols;
+      int col = cell % a_mazeMap.cols;
+
+      for(int i = 0; i < 4; i++)
+	{
+	  int nextRow = row + SEARCH_DROW[i];
+	  int nextCol = col + SEARCH_DCOL[i];
+
+	  if( mazeMapIsOpen(a_mazeMap, nextRow, nextCol) )
+	    {
+	      int next = mazeMapIndex(a_mazeMap, nextRow, nextCol);
+	      if(parentDir[next] == 0)
+		{
+		  parentDir[next] = SEARCH_DIRS[i];
+		  frontier.addQueue(next);
+		}
+	    }
+	}
+    }
+
+  delete [] parentDir;
+
+  return result;
+}
+
+/*
+ * Purpose : Finds a shortest path from the entrance to the nearest dragon
+ *         : using breadth-first searches from both ends (the dragons' half
+ *         : starts from all of them at once).  Whichever half has
+ *         : the smaller frontier expands a whole level next, so in a
+ *         : winding corridor each half covers about half the distance.
+ *         : The first time the halves touch gives a shortest path: the
+ *         : cell touched is on the other half's frontier (had it been
+ *         : expanded already, the halves would have met then), so every
+ *         : meeting found in that level is equally long.
+ * Arguments -
+ *   MazeMap& a_mazeMap : Reference to a MazeMap
+ *   Position a_entrancePos : Position to start searching from
+ *   vector<Position>& a_dragons : Positions of the dragons
+ * Returns : The search outcome
+ */
+MazeSearchResult solveMazeBidirectional(MazeMap& a_mazeMap,
+					Position a_entrancePos,
+					vector<Position>& a_dragons)
+{
+  MazeSearchResult result;
+  result.foundDragon = false;
+  result.expanded = 0;
+
+  // 0 means "not reached yet"; upper case from the entrance, lower case
+  // from the dragon
+  unsigned char* parentDir =
+    new unsigned char[a_mazeMap.rows * a_mazeMap.cols]();
+
+  Queue<int> forward(a_mazeMap.rows + a_mazeMap.cols);
+  Queue<int> backward(a_mazeMap.rows + a_mazeMap.cols);
+
+  int start = mazeMapIndex(a_mazeMap, a_entrancePos.x, a_entrancePos.y);
+  parentDir[start] = START_MARK;
+  forward.addQueue(start);
+
+  for(unsigned int i = 0; i < a_dragons.size(); i++)
+    {
+      int goal = mazeMapIndex(a_mazeMap, a_dragons[i].x, a_dragons[i].y);
+      parentDir[goal] = GOAL_MARK;
+      backward.addQueue(goal);
+    }
+
+  bool met = false;
+  bool metForward = true;
+  int meetFrom;
+  int meetDir;
+
+  while( !met && !(forward.isEmptyQueue()) && !(backward.isEmptyQueue()) )
+    {
+      metForward = (forward.size() <= backward.size());
+      met = expandLevel(a_mazeMap, parentDir,
+			metForward ? forward : backward, metForward,
+			meetFrom, meetDir, result.expanded);
+    }
+
+  if(met)
+    {
+      result.foundDragon = true;
+
+      // The edge where the halves met, as a forward move
+      int forwardCell;
+      int backwardCell;
+      char bridge = SEARCH_DIRS[meetDir];
+      int meetRow = meetFrom / a_mazeMap.cols + SEARCH_DROW[meetDir];
+      int meetCol = meetFrom % a_mazeMap.cols + SEARCH_DCOL[meetDir];
+      int meetTo = mazeMapIndex(a_mazeMap, meetRow, meetCol);
+
+      if(metForward)
+	{
+	  forwardCell = meetFrom;
+	  backwardCell = meetTo;
+	}
+      else
+	{
+	  forwardCell = meetTo;
+	  backwardCell = meetFrom;
+	  bridge = oppositeDir(bridge);
+	}
+
+      // Entrance to the meeting point, then across, then back along the
+      // dragon's half (whose moves point away from the dragon)
+      tracePath(a_mazeMap, parentDir, forwardCell, result.path);
+      result.path.addMove(bridge);
+
+      int cell = backwardCell;
+      while(parentDir[cell] != GOAL_MARK)
+	{
+	  char dir = toupper(parentDir[cell]);
+	  result.path.addMove(oppositeDir(dir));
+	  cell = stepBack(a_mazeMap, cell, dir);
+	}
+    }
+
+  delete [] parentDir;
+
+  return result;
+}
+
+/*
+ * Purpose : Finds, for every dragon, a shortest path from the nearest
+ *         : entrance.  All entrances start on the frontier together, so
+ *         : one breadth-first search reaches each cell from whichever
+ *         : entrance is nearest, and walking a dragon's parent directions
+ *         : back ends at that entrance.  The search stops once every
+ *         : dragon is reached.
+ * Arguments -
+ *   MazeMap& a_mazeMap : Reference to a MazeMap
+ *   vector<Position>& a_entrances : Positions of the entrances
+ *   vector<DragonRoute>& a_routes : One per dragon, with its position set;
+ *                                 : receives the routes
+ * Returns : Number of cells expanded
+ */
+long solveMazeMultiSource(MazeMap& a_mazeMap, vector<Position>& a_entrances,
+			  vector<DragonRoute>& a_routes)
+{
+  long expanded = 0;
+
+  // 0 means "not reached yet"
+  unsigned char* parentDir =
+    new unsigned char[a_mazeMap.rows * a_mazeMap.cols]();
+
+  Queue<int> frontier(2 * (a_mazeMap.rows + a_mazeMap.cols));
+
+  for(unsigned int i = 0; i < a_entrances.size(); i++)
+    {
+      int start = mazeMapIndex(a_mazeMap, a_entrances[i].x,
+			       a_entrances[i].y);
+      parentDir[start] = START_MARK;
+      frontier.addQueue(start);
+    }
+
+  unsigned int dragonsLeft = a_routes.size();
+
+  while( (dragonsLeft > 0) && !(frontier.isEmptyQueue()) )
+    {
+      int cell = frontier.front();
+      frontier.deleteQueue();
+      expanded++;
+
+      if(mazeMapCellAt(a_mazeMap, cell) == 'd')
+	dragonsLeft--;
+
+      int row = cell / a_mazeMap.cols;
+      int col = cell % a_mazeMap.cols;
+
+      for(int i = 0; i < 4; i++)
+	{
+	  int nextRow = row + SEARCH_DROW[i];
+	  int nextCol = col + SEARCH_DCOL[i];
+
+	  if( mazeMapIsOpen(a_mazeMap, nextRow, nextCol) )
+	    {
+	      int next = mazeMapIndex(a_mazeMap, nextRow, nextCol);
+	      if(parentDir[next] == 0)
+		{
+		  parentDir[next] = SEARCH_DIRS[i];
+		  frontier.addQueue(next);
+		}
+	    }
+	}
+    }
+
+  for(unsigned int i = 0; i < a_routes.size(); i++)
+    {
+      int goal = mazeMapIndex(a_mazeMap, a_routes[i].dragon.x,
+			      a_routes[i].dragon.y);
+
+      a_routes[i].reached = (parentDir[goal] != 0);
+      if(a_routes[i].reached)
+	tracePath(a_mazeMap, parentDir, goal, a_routes[i].path);
+    }
+
+  delete [] parentDir;
+
+  return expanded;
+}
+
+/*
+ * Purpose : Finds a shortest path from the entrance to the dragon using
+ *         : a level-synchronous breadth-first search.  Each level of the
+ *         : frontier is split into slices that threads expand at once,
+ *         : claiming cells with an atomic exchange.  Levels with a wide
+ *         : frontier are expanded bottom-up instead (see
+ *         : expandBottomUpTask()), and narrow ones on one thread, since
+ *         : a corridor gains nothing from waking the pool.  The path is
+ *         : walked back from the dragon through the level codes, so it
+ *         : comes out the same however many threads are used.
+ * Arguments -
+ *   MazeMap& a_mazeMap : Reference to a MazeMap
+ *   Position a_entrancePos : Position to start searching from
+ *   int a_threadCount : Threads to search on (0 means one per core)
+ * Returns : The search outcome
+ */
+MazeSearchResult solveMazeParallelBFS(MazeMap& a_mazeMap,
+				      Position a_entrancePos,
+				      int a_threadCount)
+{
+  MazeSearchResult result;
+  result.foundDragon = false;
+  result.expanded = 0;
+
+  ThreadPool pool(a_threadCount);
+  int maxTasks = pool.getThreadCount() * PARALLEL_BFS_TASKS_PER_THREAD;
+
+  ParallelBFSState state;
+  state.mazeMap = &a_mazeMap;
+  state.cellCount = a_mazeMap.rows * a_mazeMap.cols;
+  state.levels = new atomic<unsigned char>[state.cellCount];
+  state.frontier = new vector<int>[maxTasks];
+  state.next = new vector<int>[maxTasks];
+  state.dragonCell = INT_MAX;
+
+  // Clear the level grid and count the open cells
+  state.taskCount = maxTasks;
+  state.openCounts.resize(maxTasks);
+  pool.runTasks(maxTasks, clearLevelsTask, &state);
+
+  long openCells = 0;
+  for(int i = 0; i < maxTasks; i++)
+    openCells += state.openCounts[i];
+
+  int start = mazeMapIndex(a_mazeMap, a_entrancePos.x, a_entrancePos.y);
+  state.levels[start].store(levelCode(0));
+  state.frontier[0].push_back(start);
+  state.offsets.push_back(0);
+  state.offsets.push_back(1);
+  state.frontierSize = 1;
+  state.level = 0;
+
+  long unreached = openCells;
+  bool bottomUp = false;
+
+  while( (state.frontierSize > 0) && (state.dragonCell == INT_MAX) )
+    {
+      result.expanded += state.frontierSize;
+      unreached -= state.frontierSize;
+
+      if( !bottomUp &&
+	  (state.frontierSize > unreached / PARALLEL_BFS_ALPHA) )
+	bottomUp = true;
+      else if( bottomUp &&
+	       (state.frontierSize < openCells / PARALLEL_BFS_BETA) )
+	bottomUp = false;
+
+      if( !bottomUp && (state.frontierSize < PARALLEL_BFS_MIN_FRONTIER) )
+	state.taskCount = 1;
+      else
+	state.taskCount = maxTasks;
+
+      for(int i = 0; i < state.taskCount; i++)
+	state.next[i].clear();
+
+      if(state.taskCount == 1)
+	expandTopDownTask(0, &state);
+      else
+	pool.runTasks(state.taskCount, bottomUp ? expandBottomUpTask :
+		      expandTopDownTask, &state);
+
+      // The next frontier becomes the frontier
+      vector<int>* spent = state.frontier;
+      state.frontier = state.next;
+      state.next = spent;
+
+      state.offsets.resize(state.taskCount + 1);
+      state.offsets[0] = 0;
+      for(int i = 0; i < state.taskCount; i++)
+	state.offsets[i + 1] = state.offsets[i] + state.frontier[i].size();
+
+      state.frontierSize = state.offsets[state.taskCount];
+      state.level++;
+    }
+
+  if(state.dragonCell != INT_MAX)
+    {
+      result.foundDragon = true;
+      result.path.setStart(a_entrancePos.x, a_entrancePos.y);
+      result.path.resize(state.level);
+
+      // Walk back one level at a time, to the first neighbour (in
+      // expansion order) a level nearer the start
+      int cell = state.dragonCell;
+      for(int level = state.level; level > 0; level--)
+	{
+	  int row = cell / a_mazeMap.cols;
+	  int col = cell % a_mazeMap.cols;
+
+	  for(int dir = 0; dir < 4; dir++)
+	    {
+	      int prevRow = row - SEARCH_DROW[dir];
+	      int prevCol = col - SEARCH_DCOL[dir];
+
+	      if( (prevRow >= 0) && (prevRow < a_mazeMap.rows) &&
+		  (prevCol >= 0) && (prevCol < a_mazeMap.cols) )
+		{
+		  int prev = mazeMapIndex(a_mazeMap, prevRow, prevCol);
+		  if(state.levels[prev].load() == levelCode(level - 1))
+		    {
+		      result.path.setMove(level - 1, SEARCH_DIRS[dir]);
+		      cell = prev;
+		      break;
+		    }
+		}
+	    }
+	}
+    }
+
+  delete [] state.levels;
+  delete [] state.frontier;
+  delete [] state.next;
+
+  return result;
+}
+
+/*
+ * Purpose : Finds a shortest path from the entrance to the nearest dragon
+ *         : using A* search.  The open set is a 4-ary heap; g-scores and
+ *         : parent directions live in flat grids.  Stale heap entries (for
+ *         : cells since reached more cheaply) are skipped when popped.
+ *         : The search stops at whichever dragon it reaches first, so the
+ *         : estimate is to the nearest of them all.
+ * Arguments -
+ *   MazeMap& a_mazeMap : Reference to a MazeMap
+ *   Position a_entrancePos : Position to start searching from
+ *   vector<Position>& a_dragons : Positions of every dragon (the goals)
+ *   MazeHeuristic a_heuristic : Estimate of the moves left to a goal
+ * Returns : The search outcome
+ */
+MazeSearchResult solveMazeAStar(MazeMap& a_mazeMap, Position a_entrancePos,
+				vector<Position>& a_dragons,
+				MazeHeuristic a_heuristic)
+{
+  MazeSearchResult result;
+  result.foundDragon = false;
+  result.expanded = 0;
+
+  int cells = a_mazeMap.rows * a_mazeMap.cols;
+
+  // -1 means "not reached yet"
+  int* gScore = new int[cells];
+  for(int i = 0; i < cells; i++)
+    gScore[i] = -1;
+
+  unsigned char* parentDir = new unsigned char[cells]();
+
+  PriorityQueue<AStarNode> openSet(2 * (a_mazeMap.rows + a_mazeMap.cols));
+
+  AStarNode node;
+  node.cell = mazeMapIndex(a_mazeMap, a_entrancePos.x, a_entrancePos.y);
+  node.g = 0;
+  node.key = ((long long)estimateMovesLeft(a_heuristic, a_entrancePos,
+					   a_dragons) << 31);
+  gScore[node.cell] = 0;
+  parentDir[node.cell] = START_MARK;
+  openSet.addQueue(node);
+
+  while( !(openSet.isEmptyQueue()) )
+    {
+      node = openSet.front();
+      openSet.deleteQueue();
+
+      // Skip entries superseded by a cheaper route
+      if(node.g != gScore[node.cell])
+	continue;
+
+      result.expanded++;
+
+      if(mazeMapCellAt(a_mazeMap, node.cell) == 'd')
+	{
+	  result.foundDragon = true;
+	  tracePath(a_mazeMap, parentDir, node.cell, result.path);
+	  break;
+	}
+
+      Position pos;
+      pos.x = node.cell / a_mazeMap.cols;
+      pos.y = node.cell % a_mazeMap.cols;
+
+      for(int i = 0; i < 4; i++)
+	{
+	  Position nextPos;
+	  nextPos.x = pos.x + SEARCH_DROW[i];
+	  nextPos.y = pos.y + SEARCH_DCOL[i];
+
+	  if( !(mazeMapIsOpen(a_mazeMap, nextPos.x, nextPos.y)) )
+	    continue;
+
+	  int next = mazeMapIndex(a_mazeMap, nextPos.x, nextPos.y);
+	  int nextG = node.g + 1;
+
+	  if( (gScore[next] == -1) || (nextG < gScore[next]) )
+	    {
+	      gScore[next] = nextG;
+	      parentDir[next] = SEARCH_DIRS[i];
+
+	      AStarNode nextNode;
+	      nextNode.cell = next;
+	      nextNode.g = nextG;
+	      long long f = nextG + estimateMovesLeft(a_heuristic, nextPos,
+						      a_dragons);
+	      nextNode.key = (f << 31) - nextG;
+	      openSet.addQueue(nextNode);
+	    }
+	}
+    }
+
+  delete [] gScore;
+  delete [] parentDir;
+
+  return result;
+}
+
+/*
+ * Purpose : Finds a shortest path from the entrance to the nearest dragon
+ *         : using IDA* search, in a fixed amount of memory.  Only the current
+ *         : path (a fixed-size array), an on-path bitmap and a table of
+ *         : the cheapest cost each cell was reached at are kept; the
+ *         : table is shared between cells when the whole maze doesn't
+ *         : fit.  Each iteration is a depth-first search that skips cells
+ *         : whose f = g + h is over the threshold; the threshold is then
+ *         : raised (by at least twice as much each time, so there are few
+ *         : iterations) and, once a path is found, the rest of that
+ *         : iteration only looks for shorter ones.
+ * Arguments -
+ *   MazeMap& a_mazeMap : Reference to a MazeMap
+ *   Position a_entrancePos : Position to start searching from
+ *   vector<Position>& a_dragons : Positions of every dragon (the goals)
+ *   MazeHeuristic a_heuristic : Estimate of the moves left to a goal
+ *   long long a_maxMemory : Bytes the search may use (0 for no limit)
+ *   bool& a_hitMemoryLimit : Set if a path was cut short because it
+ *                          : didn't fit (the path found, if any, may then
+ *                          : not be a shortest one)
+ * Returns : The search outcome
+ */
+MazeSearchResult solveMazeIDAStar(MazeMap& a_mazeMap, Position a_entrancePos,
+				  vector<Position>& a_dragons,
+				  MazeHeuristic a_heuristic,
+				  long long a_maxMemory,
+				  bool& a_hitMemoryLimit)
+{
+  MazeSearchResult result;
+  result.foundDragon = false;
+  result.expanded = 0;
+  a_hitMemoryLimit = false;
+
+  long long cells = (long long)a_mazeMap.rows * a_mazeMap.cols;
+  long long bitmapBytes = (cells + 7) / 8;
+
+  // Split what the bitmap leaves between the path and the table
+  long long pathCapacity = cells;
+  long long tableSize = cells;
+  if(a_maxMemory > 0)
+    {
+      long long spare = a_maxMemory - bitmapBytes;
+      pathCapacity = min(cells, spare / 2 / (long long)sizeof(IDAStarFrame));
+      tableSize = min(cells, (spare - pathCapacity *
+			      (long long)sizeof(IDAStarFrame)) /
+		      (long long)sizeof(IDAStarEntry));
+    }
+
+  if( (pathCapacity < 1) || (tableSize < 1) )
+    {
+      // Not even the start fits
+      a_hitMemoryLimit = true;
+      return result;
+    }
+
+  IDAStarFrame* path = new IDAStarFrame[pathCapacity];
+  unsigned char* onPath = new unsigned char[bitmapBytes]();
+  IDAStarEntry* table = new IDAStarEntry[tableSize];
+
+  int start = mazeMapIndex(a_mazeMap, a_entrancePos.x, a_entrancePos.y);
+  long long threshold = estimateMovesLeft(a_heuristic, a_entrancePos,
+					  a_dragons);
+  long long raise = IDASTAR_FIRST_RAISE;
+
+  // Paths this long or longer can't beat the one already found
+  long long bound = LLONG_MAX;
+
+  bool exactTable = (tableSize == cells);
+  for(long long i = 0; i < tableSize; i++)
+    table[i].cell = -1;
+
+  for(int iteration = 0; ; iteration++)
+    {
+      // Lowest f skipped for being over the threshold
+      long long nextThreshold = LLONG_MAX;
+
+      int depth = 0;
+      path[0].cell = start;
+      path[0].nextDir = 0;
+      onPath[start / 8] |= (1 << (start % 8));
+      result.expanded++;
+
+      while(depth >= 0)
+	{
+	  IDAStarFrame& frame = path[depth];
+
+	  if(frame.nextDir == 4)
+	    {
+	      // Every neighbour tried: step back
+	      onPath[frame.cell / 8] &= ~(1 << (frame.cell % 8));
+	      depth--;
+	      continue;
+	    }
+
+	  int i = frame.nextDir++;
+	  Position nextPos;
+	  nextPos.x = frame.cell / a_mazeMap.cols + SEARCH_DROW[i];
+	  nextPos.y = frame.cell % a_mazeMap.cols + SEARCH_DCOL[i];
+
+	  if( !(mazeMapIsOpen(a_mazeMap, nextPos.x, nextPos.y)) )
+	    continue;
+
+	  int next = mazeMapIndex(a_mazeMap, nextPos.x, nextPos.y);
+	  if(onPath[next / 8] & (1 << (next % 8)))
+	    continue;
+
+	  // Reached before at no more cost: nothing new below it.  Costs
+	  // from earlier iterations only hold when every cell has its own
+	  // slot (a shared slot may have lost the cells that led there).
+	  int g = depth + 1;
+	  IDAStarEntry& entry = table[exactTable ? next :
+				      (next * 2654435761u) % tableSize];
+	  if( (entry.cell == next) &&
+	      ((entry.iteration == iteration) ? (g >= entry.g) :
+	       (exactTable && (g > entry.g))) )
+	    continue;
+
+	  long long f = g + estimateMovesLeft(a_heuristic, nextPos, a_dragons);
+	  if(f >= bound)
+	    continue;
+
+	  if(f > threshold)
+	    {
+	      nextThreshold = min(nextThreshold, f);
+	      continue;
+	    }
+
+	  if(mazeMapCellAt(a_mazeMap, next) == 'd')
+	    {
+	      // A shorter path than any found so far; keep looking for one
+	      // shorter still
+	      result.foundDragon = true;
+	      result.path.setStart(a_entrancePos.x, a_entrancePos.y);
+	      result.path.resize(g);
+	      for(int step = 0; step < depth; step++)
+		result.path.setMove(step,
+				    SEARCH_DIRS[path[step].nextDir - 1]);
+	      result.path.setMove(depth, SEARCH_DIRS[i]);
+	      bound = g;
+	      continue;
+	    }
+
+	  if(g >= pathCapacity)
+	    {
+	      a_hitMemoryLimit = true;
+	      continue;
+	    }
+
+	  entry.cell = next;
+	  entry.g = g;
+	  entry.iteration = iteration;
+
+	  depth++;
+	  path[depth].cell = next;
+	  path[depth].nextDir = 0;
+	  onPath[next / 8] |= (1 << (next % 8));
+	  result.expanded++;
+	}
+
+      // Every path within the threshold has been tried, so the one found
+      // is a shortest one (unless some didn't fit)
+      if( result.foundDragon || (nextThreshold == LLONG_MAX) )
+	break;
+
+      threshold = max(nextThreshold, threshold + raise);
+      raise *= 2;
+    }
+
+  delete [] path;
+  delete [] onPath;
+  delete [] table;
+
+  return result;
+}
+
+
+//-----------------------------------------------------------------------------
+// Heuristics
+//-----------------------------------------------------------------------------
+
+/*
+ * Purpose : Estimates the moves from a cell to the nearest of several goals
+ * Arguments -
+ *   MazeHeuristic a_heuristic : Estimate of the moves left to one goal
+ *   Position a_cell : Position to estimate from
+ *   vector<Position>& a_goals : Positions of the goals
+ * Returns : The least of the heuristic's estimates (0 if there are no goals)
+ */
+int estimateMovesLeft(MazeHeuristic a_heuristic, Position a_cell,
+		      vector<Position>& a_goals)
+{
+  if(a_goals.empty())
+    return 0;
+
+  int least = a_heuristic(a_cell, a_goals[0]);
+
+  for(unsigned int i = 1; i < a_goals.size(); i++)
+    least = min(least, a_heuristic(a_cell, a_goals[i]));
+
+  return least;
+}
+
+/*
+ * Purpose : Estimates moves left as the Manhattan (taxicab) distance
+ * Arguments -
+ *   Position a_cell : Position to estimate from
+ *   Position a_goal : Position of the goal
+ * Returns : |dx| + |dy|
+ */
+int manhattanHeuristic(Position a_cell, Position a_goal)
+{
+  return abs(a_cell.x - a_goal.x) + abs(a_cell.y - a_goal.y);
+}
+
+/*
+ * Purpose : Estimates no moves left, which turns A* into Dijkstra's search
+ * Arguments -
+ *   Position : Position to estimate from (unused)
+ *   Position : Position of the goal (unused)
+ * Returns : 0
+ */
+int zeroHeuristic(Position, Position)
+{
+  return 0;
+}
+
+/*
+ * Purpose : Looks up a heuristic by name
+ * Arguments -
+ *   string a_name : Name of the heuristic ("manhattan" or "zero")
+ * Returns : The heuristic, or NULL if the name is unknown
+ */
+MazeHeuristic findHeuristic(string a_name)
+{
+  if(a_name == "manhattan")
+    return manhattanHeuristic;
+  else if(a_name == "zero")
+    return zeroHeuristic;
+  else
+    return NULL;
+}
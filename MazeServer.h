@@ -0,0 +1,47 @@
+/* ------------------------------------------------------------------------- *
+ *
+ * Filename : MazeServer.h
+ * Version  : 1.0
+ *
+ * Purpose  : Declares server mode, which keeps mazes loaded between
+ *          : requests and answers them over a Unix domain socket.  Each
+ *          : request and each reply is one line of text:
+ *          :
+ *          :   load name file       ->  ok rows cols
+ *          :   solve name [row col] ->  found length moves | none
+ *          :   unload name          ->  ok
+ *          :   shutdown             ->  ok (and the server stops)
+ *          :
+ *          : or "error" and a reason.  A solve starts from the maze's
+ *          : entrance unless a cell is given, and returns a shortest path
+ *          : to the nearest dragon, read off the distance field worked out
+ *          : when the maze was loaded.  A client sending a request longer
+ *          : than 4096 bytes is told so and disconnected.
+ *
+ * ------------------------------------------------------------------------- */
+
+#ifndef H_MazeServer
+#define H_MazeServer
+
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+
+//-----------------------------------------------------------------------------
+// Function signatures
+//-----------------------------------------------------------------------------
+
+int runMazeServer(string a_socketPath, ostream& a_out, ostream& a_err);
+  /* Purpose : Listens on a Unix domain socket and answers requests from
+   *         : any number of clients, until one asks it to shut down
+   * Arguments -
+   *   string a_socketPath : Path of the socket (an old socket there is
+   *                       : replaced; anything else is left alone)
+   *   ostream& a_out : Stream the messages are written to
+   *   ostream& a_err : Stream errors are written to
+   * Returns : 0 once shut down, -1 if the socket cannot be set up
+   */
+
+#endif
@@ -0,0 +1,486 @@
+/* ------------------------------------------------------------------------- *
+ *
+ * Filename : MazeServerImp.cpp
+ * Version  : 1.0
+ *
+ * Purpose  : Implementation of server mode.  One thread serves every
+ *          : client, waiting on all of their sockets at once with poll(),
+ *          : so the loaded mazes need no locking.  Client sockets don't
+ *          : block: replies are queued and written as each client takes
+ *          : them, so a client that stops reading holds up no one else.
+ *
+ * ------------------------------------------------------------------------- */
+
+#include <map>
+#include <sstream>
+#include <vector>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+#include "MazeServer.h"
+#include "MazeApp.h"
+#include "MazeField.h"
+
+
+//-----------------------------------------------------------------------------
+// "Support" structures
+//-----------------------------------------------------------------------------
+
+// Name: ResidentMaze
+// Purpose: A maze kept loaded between requests, with its distance field
+struct ResidentMaze
+{
+  MazeMap mazeMap;
+  DistanceField field;
+};
+
+// Name: ServerClient
+// Purpose: A connected client, with what it has sent that hasn't been
+//        : answered and the replies it hasn't taken yet
+struct ServerClient
+{
+  int socket;
+  string input;
+  string output;
+
+  /** Set when the client is to be dropped once its replies are written **/
+  bool closing;
+};
+
+
+//-----------------------------------------------------------------------------
+// Globals
+//-----------------------------------------------------------------------------
+
+/** Bytes read from a client at a time **/
+const int SERVER_READ_SIZE = 65536;
+
+/** Longest request a client may send, in bytes **/
+const size_t SERVER_MAX_REQUEST = 4096;
+
+/** Bytes of replies a client may leave waiting before its requests are
+    no longer read (or answered) until it takes them **/
+const size_t SERVER_MAX_PENDING = 1 << 20;
+
+/** Connections waiting to be accepted **/
+const int SERVER_BACKLOG = 16;
+
+
+//-----------------------------------------------------------------------------
+// Helper functions
+//-----------------------------------------------------------------------------
+
+/*
+ * Purpose : Frees a loaded maze and forgets it
+ * Arguments -
+ *   map<string, ResidentMaze>& a_mazes : The loaded mazes
+ *   map<string, ResidentMaze>::iterator a_maze : The one to unload
+ */
+static void unloadMaze(map<string, ResidentMaze>& a_mazes,
+		       map<string, ResidentMaze>::iterator a_maze)
+{
+  destroyMazeMap(a_maze->second.mazeMap);
+  a_mazes.erase(a_maze);
+}
+
+/*
+ * Purpose : Loads a maze under a name (replacing any maze of that name,
+ *         : once the file has been read) and works out its distance field
+ * Arguments -
+ *   map<string, ResidentMaze>& a_mazes : The loaded mazes
+ *   string a_name : Name requests will use for the maze
+ *   string a_fileName : Maze file
+ *   ostream& a_reply : Receives the reply
+ */
+static void loadMaze(map<string, ResidentMaze>& a_mazes, string a_name,
+		     string a_fileName, ostream& a_reply)
+{
+  // The maze already loaded under the name is kept if the file is bad
+  MazeMap mazeMap;
+  if(readMazeMapFile(mazeMap, a_fileName) == FLAGRANT_ERROR)
+    {
+      a_reply << "error cannot read " << a_fileName;
+      return;
+    }
+
+  map<string, ResidentMaze>::iterator old = a_mazes.find(a_name);
+  if(old != a_mazes.end())
+    unloadMaze(a_mazes, old);
+
+  ResidentMaze& maze = a_mazes[a_name];
+  maze.mazeMap = mazeMap;
+  buildDistanceField(maze.mazeMap, maze.field);
+
+  a_reply << "ok " << mazeMap.rows << " " << mazeMap.cols;
+}
+
+/*
+ * Purpose : Finds a shortest path from a cell of a loaded maze to its
+ *         : nearest dragon
+ * Arguments -
+ *   ResidentMaze& a_maze : The maze
+ *   istringstream& a_request : The rest of the request (a row and column,
+ *                            : or nothing for the entrance)
+ *   ostream& a_reply : Receives the reply
+ */
+static void solveMaze(ResidentMaze& a_maze, istringstream& a_request,
+		      ostream& a_reply)
+{
+  Position startPos;
+
+  if( !(a_request >> startPos.x) )
+    {
+      if( !(a_maze.mazeMap.hasEntrance) )
+	{
+	  a_reply << "error no entrance";
+	  return;
+	}
+      startPos = a_maze.mazeMap.entrancePos;
+    }
+  else if( !(a_request >> startPos.y) )
+    {
+      a_reply << "error expected row and column";
+      return;
+    }
+
+  PackedPath path;
+  if( !(queryDistanceField(a_maze.field, startPos, path)) )
+    {
+      a_reply << "none";
+      return;
+    }
+
+  a_reply << "found " << path.getLength() << " ";
+  for(long i = 0; i < path.getLength(); i++)
+    {
+      if(i > 0)
+	a_reply << "-";
+
+      a_reply << path.getMove(i);
+    }
+}
+
+/*
+ * Purpose : Answers one request
+ * Arguments -
+ *   map<string, ResidentMaze>& a_mazes : The loaded mazes
+ *   string a_line : The request
+ *   string& a_reply : Receives the reply line
+ * Returns : false if the request was to shut down
+ */
+static bool answerRequest(map<string, ResidentMaze>& a_mazes, string a_line,
+			  string& a_reply)
+{
+  istringstream request(a_line);
+  ostringstream reply;
+  string command;
+  string name;
+  bool keepServing = true;
+
+  request >> command >> name;
+
+  if(command == "load")
+    {
+      string fileName;
+      getline(request >> ws, fileName);
+      if(fileName.length() == 0)
+	reply << "error expected name and file";
+      else
+	loadMaze(a_mazes, name, fileName, reply);
+    }
+  else if( (command == "solve") || (command == "unload") )
+    {
+      map<string, ResidentMaze>::iterator maze = a_mazes.find(name);
+      if(maze == a_mazes.end())
+	reply << "error no maze named " << name;
+      else if(command == "solve")
+	solveMaze(maze->second, request, reply);
+      else
+	{
+	  unloadMaze(a_mazes, maze);
+	  reply << "ok";
+	}
+    }
+  else if(command == "shutdown")
+    {
+      reply << "ok";
+      keepServing = false;
+    }
+  else
+    {
+      reply << "error unknown request";
+    }
+
+  a_reply = reply.str() + "\n";
+  return keepServing;
+}
+
+/*
+ * Purpose : Writes as much of a client's queued replies as it will take
+ *         : without waiting
+ * Arguments -
+ *   ServerClient& a_client : The client
+ * Returns : false if the client has gone
+ */
+static bool sendReplies(ServerClient& a_client)
+{
+  size_t sent = 0;
+
+  while(sent < a_client.output.length())
+    {
+      ssize_t count = send(a_client.socket, a_client.output.data() + sent,
+			   a_client.output.length() - sent, MSG_NOSIGNAL);
+      if(count < 0)
+	{
+	  if(errno == EINTR)
+	    continue;
+	  if( (errno != EAGAIN) && (errno != EWOULDBLOCK) )
+	    return false;
+	  break;
+	}
+
+      sent += count;
+    }
+
+  a_client.output.erase(0, sent);
+  return true;
+}
+
+/*
+ * Purpose : Answers each whole line a client has sent, queueing the
+ *         : replies, until too many are waiting.  A request longer than
+ *         : SERVER_MAX_REQUEST is refused and the client dropped.
+ * Arguments -
+ *   ServerClient& a_client : The client
+ *   map<string, ResidentMaze>& a_mazes : The loaded mazes
+ *   bool& a_keepServing : Set to false if a client asked to shut down
+ */
+static void answerRequests(ServerClient& a_client,
+			   map<string, ResidentMaze>& a_mazes,
+			   bool& a_keepServing)
+{
+  size_t lineStart = 0;
+
+  while( a_keepServing && !(a_client.closing) &&
+	 (a_client.output.length() < SERVER_MAX_PENDING) )
+    {
+      size_t lineEnd = a_client.input.find('\n', lineStart);
+
+      // A line too long, or one already too long before its end has
+      // come (rather than let it grow without end)
+      size_t length = (lineEnd != string::npos) ? lineEnd - lineStart :
+	a_client.input.length() - lineStart;
+      if(length > SERVER_MAX_REQUEST)
+	{
+	  a_client.output += "error request too long\n";
+	  a_client.closing = true;
+	}
+      if( (lineEnd == string::npos) || a_client.closing )
+	break;
+
+      string line = a_client.input.substr(lineStart, length);
+      lineStart = lineEnd + 1;
+
+      if( (line.length() > 0) && (line[line.length() - 1] == '\r') )
+	line.erase(line.length() - 1);
+
+      string reply;
+      a_keepServing = answerRequest(a_mazes, line, reply);
+      a_client.output += reply;
+    }
+
+  if(a_client.closing)
+    a_client.input.clear();
+  else
+    a_client.input.erase(0, lineStart);
+}
+
+/*
+ * Purpose : Writes queued replies to a client and reads what it has sent,
+ *         : answering each whole line of it
+ * Arguments -
+ *   ServerClient& a_client : The client
+ *   short a_events : What poll() found the client's socket ready for
+ *   map<string, ResidentMaze>& a_mazes : The loaded mazes
+ *   bool& a_keepServing : Set to false if a client asked to shut down
+ * Returns : false if the client has gone (or is to be dropped)
+ */
+static bool serveClient(ServerClient& a_client, short a_events,
+			map<string, ResidentMaze>& a_mazes,
+			bool& a_keepServing)
+{
+  if( (a_events & POLLOUT) && !(sendReplies(a_client)) )
+    return false;
+
+  if( !(a_client.closing) && (a_events & (POLLIN | POLLHUP | POLLERR)) )
+    {
+      char buffer[SERVER_READ_SIZE];
+
+      ssize_t count = read(a_client.socket, buffer, sizeof(buffer));
+      if(count == 0)
+	return false;
+      else if(count > 0)
+	a_client.input.append(buffer, count);
+      else if( (errno != EINTR) && (errno != EAGAIN) &&
+	       (errno != EWOULDBLOCK) )
+	return false;
+    }
+
+  // Most replies fit in the socket's buffer, so write them without
+  // waiting to be told, and go on answering while they do
+  size_t unanswered;
+  do
+    {
+      unanswered = a_client.input.length();
+      answerRequests(a_client, a_mazes, a_keepServing);
+      if( !(sendReplies(a_client)) )
+	return false;
+    }
+  while( (a_client.input.length() < unanswered) &&
+	 a_client.output.empty() );
+
+  return !(a_client.closing && a_client.output.empty());
+}
+
+
+//-----------------------------------------------------------------------------
+// Function definitions
+//-----------------------------------------------------------------------------
+
+/*
+ * Purpose : Listens on a Unix domain socket and answers requests from
+ *         : any number of clients, until one asks it to shut down
+ * Arguments -
+ *   string a_socketPath : Path of the socket (an old socket there is
+ *                       : replaced; anything else is left alone)
+ *   ostream& a_out : Stream the messages are written to
+ *   ostream& a_err : Stream errors are written to
+ * Returns : 0 once shut down, -1 if the socket cannot be set up (or
+ *         : waiting on it fails)
+ */
+int runMazeServer(string a_socketPath, ostream& a_out, ostream& a_err)
+{
+  struct sockaddr_un address;
+  memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+
+  if(a_socketPath.length() >= sizeof(address.sun_path))
+    {
+      a_err << "Socket path \"" << a_socketPath << "\" is too long." << endl;
+      return -1;
+    }
+  strcpy(address.sun_path, a_socketPath.c_str());
+
+  // Only a socket left behind by an earlier server is removed; a file
+  // that happens to have the name is not
+  struct stat pathStat;
+  if(lstat(a_socketPath.c_str(), &pathStat) == 0)
+    {
+      if( !(S_ISSOCK(pathStat.st_mode)) )
+	{
+	  a_err << "Cannot listen on \"" << a_socketPath
+		<< "\": it exists and is not a socket." << endl;
+	  return -1;
+	}
+      unlink(a_socketPath.c_str());
+    }
+
+  int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+
+  if( (listener < 0) ||
+      (bind(listener, (struct sockaddr*)&address, sizeof(address)) < 0) ||
+      (listen(listener, SERVER_BACKLOG) < 0) )
+    {
+      a_err << "Cannot listen on \"" << a_socketPath << "\": "
+	    << strerror(errno) << endl;
+      if(listener >= 0)
+	close(listener);
+      return -1;
+    }
+
+  a_out << "Listening on \"" << a_socketPath << "\" ..." << endl;
+
+  map<string, ResidentMaze> mazes;
+  vector<ServerClient> clients;
+  vector<struct pollfd> waiting;
+  bool keepServing = true;
+  int outcome = 0;
+
+  while(keepServing)
+    {
+      // The listener first, then each client in order.  A client is
+      // read from only while few of its replies are waiting, and written
+      // to only while some are.
+      waiting.resize(clients.size() + 1);
+      waiting[0].fd = listener;
+      waiting[0].events = POLLIN;
+      for(unsigned int i = 0; i < clients.size(); i++)
+	{
+	  waiting[i + 1].fd = clients[i].socket;
+	  waiting[i + 1].events = 0;
+	  if( !(clients[i].closing) &&
+	      (clients[i].output.length() < SERVER_MAX_PENDING) )
+	    waiting[i + 1].events |= POLLIN;
+	  if( !(clients[i].output.empty()) )
+	    waiting[i + 1].events |= POLLOUT;
+	}
+      for(unsigned int i = 0; i < waiting.size(); i++)
+	waiting[i].revents = 0;
+
+      if(poll(&waiting[0], waiting.size(), -1) < 0)
+	{
+	  if(errno == EINTR)
+	    continue;
+	  a_err << "Cannot wait for requests: " << strerror(errno) << endl;
+	  outcome = -1;
+	  break;
+	}
+
+      // Serve the clients from the back, so removing one doesn't move
+      // those not yet served
+      for(int i = clients.size() - 1; (i >= 0) && keepServing; i--)
+	{
+	  if(waiting[i + 1].revents == 0)
+	    continue;
+
+	  if( !(serveClient(clients[i], waiting[i + 1].revents, mazes,
+			    keepServing)) )
+	    {
+	      close(clients[i].socket);
+	      clients.erase(clients.begin() + i);
+	    }
+	}
+
+      if( keepServing && (waiting[0].revents & POLLIN) )
+	{
+	  ServerClient client;
+	  client.socket = accept(listener, NULL, NULL);
+	  client.closing = false;
+	  if(client.socket >= 0)
+	    {
+	      fcntl(client.socket, F_SETFL,
+		    fcntl(client.socket, F_GETFL) | O_NONBLOCK);
+	      clients.push_back(client);
+	    }
+	}
+    }
+
+  for(unsigned int i = 0; i < clients.size(); i++)
+    close(clients[i].socket);
+  close(listener);
+  unlink(a_socketPath.c_str());
+
+  while( !(mazes.empty()) )
+    unloadMaze(mazes, mazes.begin());
+
+  if(outcome == 0)
+    a_out << "Asked to shut down, so no longer listening." << endl;
+
+  return outcome;
+}
@@ -0,0 +1,102 @@
+/* ------------------------------------------------------------------------- *
+ *
+ * Filename : MazeStats.h
+ * Version  : 1.0
+ *
+ * Purpose  : Declares the counters kept while a maze is solved (calls
+ *          : made by the depth-first search, and how long loading,
+ *          : solving and displaying took) and the --stats report of them.
+ *          : The depth-first search's counters are only compiled in when
+ *          : MAZEAPP_STATS is defined; otherwise MAZE_STAT_ADD() and
+ *          : MAZE_STAT_MAX() expand to nothing.
+ *
+ * ------------------------------------------------------------------------- */
+
+#ifndef H_MazeStats
+#define H_MazeStats
+
+#include <chrono>
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+
+//-----------------------------------------------------------------------------
+// "Support" structures (meaning, that they help make code pretty)
+//-----------------------------------------------------------------------------
+
+// Name: MazeStats
+// Purpose: Stores the counters of one solve
+struct MazeStats
+{
+  /** Time spent in each phase, in milliseconds **/
+  double loadMs;
+  double solveMs;
+  double renderMs;
+
+  /** Cells expanded by a search engine (-1 for the depth-first search) **/
+  long long cellsExpanded;
+
+  /** Calls made by the depth-first search **/
+  long long canMoveCalls;
+  long long makeMoveCalls;
+  long long backtrackCalls;
+  long long alreadyMadeLookups;
+
+  /** Moves undone by backtrack(), in all and in the longest one call **/
+  long long backtrackMoves;
+  long long longestBacktrack;
+
+  /** Moves taken from the Move pool **/
+  long long moveAllocations;
+};
+
+
+//-----------------------------------------------------------------------------
+// Globals
+//-----------------------------------------------------------------------------
+
+/** The counters of the solve running on this thread (each thread of a
+    batch counts its own maze) **/
+extern thread_local MazeStats mazeStats;
+
+#ifdef MAZEAPP_STATS
+#define MAZE_STAT_ADD(a_counter, a_amount) \
+  (mazeStats.a_counter += (a_amount))
+#define MAZE_STAT_MAX(a_counter, a_value) \
+  (mazeStats.a_counter = (mazeStats.a_counter < (a_value)) ? \
+			 (a_value) : mazeStats.a_counter)
+#else
+#define MAZE_STAT_ADD(a_counter, a_amount) ((void)0)
+#define MAZE_STAT_MAX(a_counter, a_value) ((void)0)
+#endif
+
+
+//-----------------------------------------------------------------------------
+// Function signatures
+//-----------------------------------------------------------------------------
+
+void resetMazeStats();
+  /* Purpose : Zeroes this thread's counters, before a solve
+   */
+
+double lapMilliseconds(chrono::steady_clock::time_point& a_start);
+  /* Purpose : Times a phase of a solve
+   * Arguments -
+   *   chrono::steady_clock::time_point& a_start : When the phase started;
+   *                                             : moved on to now, when
+   *                                             : the next phase starts
+   * Returns : Milliseconds since a_start
+   */
+
+void displayMazeStats(string a_inputFileName, ostream& a_out);
+  /* Purpose : Writes this thread's counters as one line of JSON.  The
+   *         : depth-first search's counters are left out (and "counted"
+   *         : is false) when they weren't compiled in.
+   * Arguments -
+   *   string a_inputFileName : Maze file the counters are for
+   *   ostream& a_out : Stream the report is written to
+   */
+
+#endif
@@ -0,0 +1,127 @@
+/* ------------------------------------------------------------------------- *
+ *
+ * Filename : MazeStatsImp.cpp
+ * Version  : 1.0
+ *
+ * Purpose  : Implementation of the solve counters and their report.
+ *
+ * ------------------------------------------------------------------------- */
+
+#include <iomanip>
+#include <stdio.h>
+#include <string.h>
+
+#include "MazeStats.h"
+
+
+//-----------------------------------------------------------------------------
+// Globals
+//-----------------------------------------------------------------------------
+
+thread_local MazeStats mazeStats;
+
+
+//-----------------------------------------------------------------------------
+// Helper functions
+//-----------------------------------------------------------------------------
+
+/*
+ * Purpose : Writes a string as a JSON string (quoted, with quotes,
+ *         : backslashes and control characters escaped)
+ * Arguments -
+ *   string a_text : The string
+ *   ostream& a_out : Stream it is written to
+ */
+static void writeJsonString(string a_text, ostream& a_out)
+{
+  a_out << '"';
+
+  for(unsigned int i = 0; i < a_text.length(); i++)
+    {
+      unsigned char c = a_text[i];
+
+      if( (c == '"') || (c == '\\') )
+	a_out << '\\' << c;
+      else if(c < 0x20)
+	{
+	  char escape[8];
+	  snprintf(escape, sizeof(escape), "\\u%04x", c);
+	  a_out << escape;
+	}
+      else
+	a_out << c;
+    }
+
+  a_out << '"';
+}
+
+
+//-----------------------------------------------------------------------------
+// Function definitions
+//-----------------------------------------------------------------------------
+
+/*
+ * Purpose : Zeroes this thread's counters, before a solve
+ */
+void resetMazeStats()
+{
+  memset(&mazeStats, 0, sizeof(mazeStats));
+  mazeStats.cellsExpanded = -1;
+}
+
+/*
+ * Purpose : Times a phase of a solve
+ * Arguments -
+ *   chrono::steady_clock::time_point& a_start : When the phase started
+ *                                             : (moved on to now)
+ * Returns : Milliseconds since a_start
+ */
+double lapMilliseconds(chrono::steady_clock::time_point& a_start)
+{
+  chrono::steady_clock::time_point now = chrono::steady_clock::now();
+  double milliseconds =
+    chrono::duration<double, milli>(now - a_start).count();
+
+  a_start = now;
+  return milliseconds;
+}
+
+/*
+ * Purpose : Writes this thread's counters as one line of JSON
+ * Arguments -
+ *   string a_inputFileName : Maze file the counters are for
+ *   ostream& a_out : Stream the report is written to
+ */
+void displayMazeStats(string a_inputFileName, ostream& a_out)
+{
+  ios::fmtflags flags = a_out.flags();
+  streamsize precision = a_out.precision();
+
+  a_out << "{\"file\": ";
+  writeJsonString(a_inputFileName, a_out);
+  a_out << fixed << setprecision(3) << ", \"load_ms\": " << mazeStats.loadMs
+	<< ", \"solve_ms\": " << mazeStats.solveMs << ", \"render_ms\": "
+	<< mazeStats.renderMs << ", \"cells_expanded\": ";
+  if(mazeStats.cellsExpanded >= 0)
+    a_out << mazeStats.cellsExpanded;
+  else
+    a_out << "null";
+
+#ifdef MAZEAPP_STATS
+  a_out << ", \"counted\": true, \"can_move_calls\": "
+	<< mazeStats.canMoveCalls << ", \"make_move_calls\": "
+	<< mazeStats.makeMoveCalls << ", \"backtrack_calls\": "
+	<< mazeStats.backtrackCalls << ", \"backtrack_moves\": "
+	<< mazeStats.backtrackMoves << ", \"longest_backtrack\": "
+	<< mazeStats.longestBacktrack << ", \"already_made_lookups\": "
+	<< mazeStats.alreadyMadeLookups << ", \"move_allocations\": "
+	<< mazeStats.moveAllocations;
+#else
+  a_out << ", \"counted\": false";
+#endif
+
+  a_out << "}" << endl;
+
+  a_out.flags(flags);
+  a_out.precision(precision);
+}
@@ -0,0 +1,91 @@
+/* ------------------------------------------------------------------------- *
+ *
+ * Filename : MazeStream.h
+ * Version  : 1.0
+ *
+ * Purpose  : Declares the streaming solver, for mazes too big to hold in
+ *          : memory.  The maze file is mapped and read a band of rows at
+ *          : a time.  Reachability is found in one pass that keeps only
+ *          : the component labels of the last row read; the path length,
+ *          : if asked for, keeps the distances along each band's top and
+ *          : bottom rows between sweeps.
+ *
+ * ------------------------------------------------------------------------- */
+
+#ifndef H_MazeStream
+#define H_MazeStream
+
+#include <string>
+
+#include "MazeApp.h"
+
+using namespace std;
+
+
+//-----------------------------------------------------------------------------
+// "Support" structures (meaning, that they help make code pretty)
+//-----------------------------------------------------------------------------
+
+// Name: MazeStreamResult
+// Purpose: Stores the outcome of a streaming solve
+struct MazeStreamResult
+{
+  /** Was an entrance found, and where (the first, in row-major order)? **/
+  bool foundEntrance;
+  long long entranceRow;
+  long long entranceCol;
+
+  /** Can a dragon be reached? **/
+  bool foundDragon;
+
+  /** Moves on the shortest path the sweeps found (-1 if they were not run
+      or found none), and whether they settled, so that no path is
+      shorter **/
+  long long length;
+  bool lengthExact;
+
+  /** Were the sweeps skipped because the band edges' distances would not
+      fit in the memory budget? **/
+  bool edgesTooBig;
+
+  /** Rows per band, number of bands, and sweeps spent on the length **/
+  long long bandRows;
+  long long bandCount;
+  int sweeps;
+};
+
+
+//-----------------------------------------------------------------------------
+// Globals
+//-----------------------------------------------------------------------------
+
+/** Memory the streaming solver stays within: half for the band being
+    solved (when it picks the band size itself), half for the band edges'
+    distances (or it does not work out the path length) **/
+const long long STREAM_MEMORY_BUDGET = 1LL << 30;
+
+
+//-----------------------------------------------------------------------------
+// Function signatures
+//-----------------------------------------------------------------------------
+
+int solveMazeStream(string a_inputFileName, long long a_bandRows,
+		    int a_maxSweeps, MazeStreamResult& a_result);
+  /* Purpose : Finds whether a dragon can be reached from the entrance
+   *         : without loading the whole maze, in one pass over it.  If
+   *         : asked, it then works out the length of a shortest path: each
+   *         : band is solved with a breadth-first search seeded from the
+   *         : distances along its neighbours' edge rows, and the bands are
+   *         : swept down and up until those distances settle.
+   * Arguments -
+   *   string a_inputFileName : Maze file (text or binary format)
+   *   long long a_bandRows : Rows per band (0 to pick from the memory
+   *                        : budget)
+   *   int a_maxSweeps : Most sweeps to spend on the path length (0 for
+   *                   : none)
+   *   MazeStreamResult& a_result : Receives the outcome
+   * Returns : 0 if the maze was solved, -1 if the file cannot be read or
+   *         : its rows are not all the same length
+   */
+
+#endif
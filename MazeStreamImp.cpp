@@ -0,0 +1,814 @@
+/* ------------------------------------------------------------------------- *
+ *
+ * Filename : MazeStreamImp.cpp
+ * Version  : 1.0
+ *
+ * Purpose  : Implementation of the streaming solver.  The file is mapped,
+ *          : not read, so only the band being solved needs to be in
+ *          : memory; its pages are dropped again once it is done.
+ *          : Reachability takes one pass, keeping component labels for a
+ *          : single row; the path length takes further, optional sweeps.
+ *
+ * ------------------------------------------------------------------------- */
+
+#include <algorithm>
+#include <climits>
+#include <utility>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "MazeBinary.h"
+#include "MazeScan.h"
+#include "MazeStream.h"
+#include "Queue.h"
+
+
+//-----------------------------------------------------------------------------
+// Globals
+//-----------------------------------------------------------------------------
+
+/** Direction offsets (in the order the search engines use) **/
+const int STREAM_DROW[4] = { 0, -1, 0, 1 };
+const int STREAM_DCOL[4] = { 1, 0, -1, 0 };
+
+/** Distance of a cell no path has reached yet **/
+const long long STREAM_UNREACHED = LLONG_MAX;
+
+/** Working memory for each cell of a band (its distance and a queue
+    entry), and for each column of a band's edges (two distances) **/
+const long long STREAM_BYTES_PER_CELL = 12;
+const long long STREAM_BYTES_PER_EDGE = 16;
+
+/** What a connected component of open cells holds **/
+const char STREAM_HOLDS_ENTRANCE = 1;
+const char STREAM_HOLDS_DRAGON = 2;
+
+
+//-----------------------------------------------------------------------------
+// "Support" structures
+//-----------------------------------------------------------------------------
+
+// Name: MazeStreamSource
+// Purpose: The mapped maze file being streamed
+struct MazeStreamSource
+{
+  const char* file;
+  size_t length;
+  bool binary;
+
+  long long rows;
+  long long cols;
+
+  /** Where the rows are, in a text file **/
+  MazeMapLayout layout;
+
+  /** Header, landmarks and wall bitmap, in a binary file **/
+  const MazeBinaryHeader* header;
+  const unsigned int* landmarks;
+  const unsigned long long* walls;
+};
+
+// Name: MazeStreamState
+// Purpose: Everything kept from one band to the next
+struct MazeStreamState
+{
+  MazeStreamSource source;
+
+  long long bandRows;
+  long long bandCount;
+
+  /** Distances along the top and bottom row of each band **/
+  vector< vector<long long> > topDist;
+  vector< vector<long long> > bottomDist;
+
+  /** Distance to the nearest dragon found in each band **/
+  vector<long long> bandDragon;
+
+  /** The entrance, once the band holding it has been seen **/
+  bool foundEntrance;
+  long long entranceRow;
+  long long entranceCol;
+
+  /** Distances of the band being solved (kept to reuse its memory) **/
+  vector<long long> dist;
+};
+
+// Name: MazeStreamLabels
+// Purpose: The connected components of the open cells read so far, as far
+//        : as they reach the last row read
+struct MazeStreamLabels
+{
+  /** Component of each cell of the last row read (-1 for a wall), and of
+      the row being read **/
+  vector<int> rowLabel;
+  vector<int> nextRowLabel;
+
+  /** Union-find over the labels of both rows, and what each component
+      holds (STREAM_HOLDS_ flags, kept at its root) **/
+  vector<int> parent;
+  vector<char> holds;
+
+  /** Scratch space for numbering the components of a finished row **/
+  vector<int> renumber;
+  vector<char> renumberedHolds;
+
+  /** Is the answer known yet, and what is it? **/
+  bool answered;
+  bool reachable;
+};
+
+
+//-----------------------------------------------------------------------------
+// Helper functions
+//-----------------------------------------------------------------------------
+
+/*
+ * Purpose : Lets the kernel drop the pages behind part of the mapped file
+ *         : (they are read back in if the band is needed again)
+ * Arguments -
+ *   const void* a_start : Start of the bytes
+ *   size_t a_length : Number of bytes
+ */
+static void dropPages(const void* a_start, size_t a_length)
+{
+  size_t pageSize = sysconf(_SC_PAGESIZE);
+  size_t start = (size_t)a_start;
+  size_t pageStart = start & ~(pageSize - 1);
+
+  madvise((void*)pageStart, a_length + (start - pageStart), MADV_DONTNEED);
+}
+
+/*
+ * Purpose : Finds the first landmark on or after a row, in a row-major list
+ * Arguments -
+ *   const unsigned int* a_list : (row, col) pairs, in row-major order
+ *   long long a_count : Number of pairs
+ *   long long a_row : Row to look from
+ * Returns : Index of the first pair on a_row or later (a_count if none)
+ */
+static long long firstLandmarkFrom(const unsigned int* a_list,
+				   long long a_count, long long a_row)
+{
+  long long low = 0;
+  long long high = a_count;
+
+  while(low < high)
+    {
+      long long middle = low + (high - low) / 2;
+      if((long long)a_list[2 * middle] < a_row)
+	low = middle + 1;
+      else
+	high = middle;
+    }
+
+  return low;
+}
+
+/*
+ * Purpose : Loads one band of rows: its passability bitmap, its first
+ *         : entrance and its dragons
+ * Arguments -
+ *   MazeStreamSource& a_source : The mapped file
+ *   long long a_firstRow : First row of the band
+ *   int a_rowCount : Rows in the band
+ *   MazeMap& a_band : Receives the band (tiles only for text files)
+ *   vector<Position>& a_dragons : Receives its dragons (band-relative)
+ * Returns : true if the band's rows are well-formed
+ */
+static bool loadBand(MazeStreamSource& a_source, long long a_firstRow,
+		     int a_rowCount, MazeMap& a_band,
+		     vector<Position>& a_dragons)
+{
+  a_band.rows = a_rowCount;
+  a_band.cols = a_source.cols;
+  a_band.visited = NULL;
+  a_band.mapping = NULL;
+  a_band.mappingLength = 0;
+
+  if( !(a_source.binary) )
+    {
+      if( !(mazeMapRowsValid(a_source.file, a_source.length,
+			     a_source.layout, a_firstRow, a_rowCount)) )
+	return false;
+
+      // The tiles are used in place
+      a_band.map = (char*)a_source.file + a_source.layout.dataStart +
+	a_firstRow * a_source.layout.stride;
+      a_band.stride = a_source.layout.stride;
+
+      scanMazeMap(a_band);
+      listMazeMapTiles(a_band, 'd', a_dragons);
+      return true;
+    }
+
+  /** BINARY FILE: INVERT THE WALLS, THEN PLACE THE LANDMARKS **/
+
+  int words = a_source.header->wordsPerRow;
+  long bandWords = (long)a_rowCount * words;
+  const unsigned long long* walls = a_source.walls + a_firstRow * words;
+
+  a_band.map = NULL;
+  a_band.stride = a_band.cols;
+  a_band.openWords = words;
+  a_band.openBits = new unsigned long long[bandWords];
+
+  unsigned long long lastWordMask = ~0ULL;
+  if(a_band.cols % 64 != 0)
+    lastWordMask = (1ULL << (a_band.cols % 64)) - 1;
+
+  for(long w = 0; w < bandWords; w++)
+    {
+      a_band.openBits[w] = ~walls[w];
+      if(w % words == words - 1)
+	a_band.openBits[w] &= lastWordMask;
+    }
+
+  long long entranceCount = a_source.header->entranceCount;
+  long long dragonCount = a_source.header->dragonCount;
+  const unsigned int* entrances = a_source.landmarks;
+  const unsigned int* dragons = a_source.landmarks + 2 * entranceCount;
+
+  a_band.hasEntrance = false;
+  a_dragons.clear();
+
+  // Entrances can't be moved to; dragons can
+  for(long long i = firstLandmarkFrom(entrances, entranceCount, a_firstRow);
+      (i < entranceCount) && (entrances[2 * i] < a_firstRow + a_rowCount);
+      i++)
+    {
+      int row = entrances[2 * i] - a_firstRow;
+      int col = entrances[2 * i + 1];
+      if(col >= a_band.cols)
+	continue;
+
+      a_band.openBits[row * words + (col >> 6)] &= ~(1ULL << (col & 63));
+      if( !(a_band.hasEntrance) )
+	{
+	  a_band.hasEntrance = true;
+	  a_band.entrancePos.x = row;
+	  a_band.entrancePos.y = col;
+	}
+    }
+
+  for(long long i = firstLandmarkFrom(dragons, dragonCount, a_firstRow);
+      (i < dragonCount) && (dragons[2 * i] < a_firstRow + a_rowCount); i++)
+    {
+      Position pos;
+      pos.x = dragons[2 * i] - a_firstRow;
+      pos.y = dragons[2 * i + 1];
+      if(pos.y >= a_band.cols)
+	continue;
+
+      a_band.openBits[pos.x * words + (pos.y >> 6)] |= 1ULL << (pos.y & 63);
+      a_dragons.push_back(pos);
+    }
+
+  return true;
+}
+
+/*
+ * Purpose : Frees a band and drops its pages of the mapped file
+ * Arguments -
+ *   MazeStreamSource& a_source : The mapped file
+ *   long long a_firstRow : First row of the band
+ *   MazeMap& a_band : The band
+ */
+static void releaseBand(MazeStreamSource& a_source, long long a_firstRow,
+			MazeMap& a_band)
+{
+  if(a_source.binary)
+    dropPages(a_source.walls + a_firstRow * a_band.openWords,
+	      (size_t)a_band.rows * a_band.openWords *
+	      sizeof(unsigned long long));
+  else
+    dropPages(a_band.map, (size_t)a_band.rows * a_band.stride);
+
+  delete [] a_band.openBits;
+  a_band.openBits = NULL;
+}
+
+/*
+ * Purpose : Finds the component a label belongs to (halving the paths on
+ *         : the way, so later finds are quicker)
+ * Arguments -
+ *   vector<int>& a_parent : Union-find parents
+ *   int a_label : Label to look up
+ * Returns : Root label of its component
+ */
+static int findComponent(vector<int>& a_parent, int a_label)
+{
+  while(a_parent[a_label] != a_label)
+    {
+      a_parent[a_label] = a_parent[a_parent[a_label]];
+      a_label = a_parent[a_label];
+    }
+
+  return a_label;
+}
+
+/*
+ * Purpose : Adds to what a component holds, and notes when it is found to
+ *         : hold both the entrance and a dragon
+ * Arguments -
+ *   MazeStreamLabels& a_labels : The components
+ *   int a_label : Any label of the component
+ *   char a_holds : STREAM_HOLDS_ flags to add
+ */
+static void markComponent(MazeStreamLabels& a_labels, int a_label,
+			  char a_holds)
+{
+  int root = findComponent(a_labels.parent, a_label);
+  a_labels.holds[root] |= a_holds;
+
+  if(a_labels.holds[root] == (STREAM_HOLDS_ENTRANCE | STREAM_HOLDS_DRAGON))
+    {
+      a_labels.answered = true;
+      a_labels.reachable = true;
+    }
+}
+
+/*
+ * Purpose : Merges the components of two labels
+ * Arguments -
+ *   MazeStreamLabels& a_labels : The components
+ *   int a_first : Label in one component
+ *   int a_second : Label in the other
+ */
+static void joinComponents(MazeStreamLabels& a_labels, int a_first,
+			   int a_second)
+{
+  int first = findComponent(a_labels.parent, a_first);
+  int second = findComponent(a_labels.parent, a_second);
+
+  if(first != second)
+    {
+      a_labels.parent[first] = second;
+      markComponent(a_labels, second, a_labels.holds[first]);
+    }
+}
+
+/*
+ * Purpose : Labels the components of one row of a band, joining them to
+ *         : the components of the row above, then numbers them afresh so
+ *         : only this row's labels are kept.  The first entrance counts as
+ *         : open here: a path that went back through it could start there
+ *         : instead, so it joins nothing that is not reachable anyway.
+ * Arguments -
+ *   MazeStreamState& a_state : The solve so far
+ *   MazeStreamLabels& a_labels : The components so far
+ *   MazeMap& a_band : The band
+ *   int a_row : Row within the band
+ *   long long a_firstRow : First row of the band
+ *   vector<Position>& a_dragons : The band's dragons (in row-major order)
+ *   unsigned int& a_nextDragon : First of them not yet on a row read
+ */
+static void labelRow(MazeStreamState& a_state, MazeStreamLabels& a_labels,
+		     MazeMap& a_band, int a_row, long long a_firstRow,
+		     vector<Position>& a_dragons, unsigned int& a_nextDragon)
+{
+  int cols = a_band.cols;
+  long long row = a_firstRow + a_row;
+  vector<int>& above = a_labels.rowLabel;
+  vector<int>& labels = a_labels.nextRowLabel;
+
+  bool entranceRow = a_state.foundEntrance && (a_state.entranceRow == row);
+
+  /** LABEL THE RUNS OF OPEN CELLS, JOINING THEM TO THE ROW ABOVE **/
+
+  for(int col = 0; col < cols; col++)
+    {
+      if( !(mazeMapOpenTile(a_band, a_row, col)) &&
+	  !(entranceRow && (col == a_state.entranceCol)) )
+	{
+	  labels[col] = -1;
+	  continue;
+	}
+
+      if( (col > 0) && (labels[col - 1] >= 0) )
+	labels[col] = labels[col - 1];
+      else
+	{
+	  labels[col] = a_labels.parent.size();
+	  a_labels.parent.push_back(labels[col]);
+	  a_labels.holds.push_back(0);
+	}
+
+      // Along a run under one component of the row above, only the first
+      // cell needs joining
+      if( (above[col] >= 0) &&
+	  !( (col > 0) && (labels[col - 1] == labels[col]) &&
+	     (above[col - 1] == above[col]) ) )
+	joinComponents(a_labels, labels[col], above[col]);
+    }
+
+  if(entranceRow)
+    markComponent(a_labels, labels[a_state.entranceCol],
+		  STREAM_HOLDS_ENTRANCE);
+
+  while( (a_nextDragon < a_dragons.size()) &&
+	 (a_dragons[a_nextDragon].x == a_row) )
+    {
+      int label = labels[a_dragons[a_nextDragon].y];
+      if(label >= 0)
+	markComponent(a_labels, label, STREAM_HOLDS_DRAGON);
+      a_nextDragon++;
+    }
+
+  /** KEEP ONLY THIS ROW'S COMPONENTS, NUMBERED FROM 0 **/
+
+  a_labels.renumber.assign(a_labels.parent.size(), -1);
+  a_labels.renumberedHolds.clear();
+
+  for(int col = 0; col < cols; col++)
+    {
+      if(labels[col] < 0)
+	continue;
+
+      int root = findComponent(a_labels.parent, labels[col]);
+      if(a_labels.renumber[root] < 0)
+	{
+	  a_labels.renumber[root] = a_labels.renumberedHolds.size();
+	  a_labels.renumberedHolds.push_back(a_labels.holds[root]);
+	}
+      labels[col] = a_labels.renumber[root];
+    }
+
+  a_labels.holds.swap(a_labels.renumberedHolds);
+  a_labels.parent.resize(a_labels.holds.size());
+  for(unsigned int i = 0; i < a_labels.parent.size(); i++)
+    a_labels.parent[i] = i;
+
+  above.swap(labels);
+
+  // Once the entrance's component stops reaching the rows being read, no
+  // dragon further down can join it
+  if( a_state.foundEntrance && (row >= a_state.entranceRow) &&
+      !(a_labels.answered) &&
+      (find(a_labels.holds.begin(), a_labels.holds.end(),
+	    STREAM_HOLDS_ENTRANCE) == a_labels.holds.end()) )
+    {
+      a_labels.answered = true;
+      a_labels.reachable = false;
+    }
+}
+
+/*
+ * Purpose : Finds whether a dragon can be reached from the entrance, in one
+ *         : pass down the bands.  Only the component labels of the last
+ *         : row read are kept between rows, so the memory needed beyond
+ *         : the band is a few bytes per column.  The pass stops as soon as
+ *         : the answer is known.
+ * Arguments -
+ *   MazeStreamState& a_state : The solve so far
+ *   bool& a_reachable : Receives whether a dragon can be reached
+ * Returns : 0 if the rows read were well-formed, -1 if not
+ */
+static int findReachable(MazeStreamState& a_state, bool& a_reachable)
+{
+  int cols = a_state.source.cols;
+
+  MazeStreamLabels labels;
+  labels.rowLabel.assign(cols, -1);
+  labels.nextRowLabel.assign(cols, -1);
+  labels.answered = false;
+  labels.reachable = false;
+
+  for(long long i = 0; (i < a_state.bandCount) && !(labels.answered); i++)
+    {
+      long long firstRow = i * a_state.bandRows;
+      int rowCount = min(a_state.bandRows, a_state.source.rows - firstRow);
+
+      MazeMap band;
+      vector<Position> dragons;
+      if( !(loadBand(a_state.source, firstRow, rowCount, band, dragons)) )
+	return -1;
+
+      if( !(a_state.foundEntrance) && band.hasEntrance )
+	{
+	  a_state.foundEntrance = true;
+	  a_state.entranceRow = firstRow + band.entrancePos.x;
+	  a_state.entranceCol = band.entrancePos.y;
+	}
+
+      unsigned int nextDragon = 0;
+      for(int row = 0; (row < rowCount) && !(labels.answered); row++)
+	labelRow(a_state, labels, band, row, firstRow, dragons, nextDragon);
+
+      releaseBand(a_state.source, firstRow, band);
+    }
+
+  a_reachable = labels.reachable;
+
+  return 0;
+}
+
+/*
+ * Purpose : Solves one band: a breadth-first search from the entrance (if
+ *         : it is in the band) and from the cells next to the band whose
+ *         : distances its neighbours have found.  The seeds join the
+ *         : search in order of distance, so each cell is still reached
+ *         : first by its shortest way in.
+ * Arguments -
+ *   MazeStreamState& a_state : The solve so far
+ *   long long a_band : Index of the band
+ * Returns : 1 if the distances along the band's edges changed, 0 if not,
+ *         : -1 if its rows are not well-formed
+ */
+static int solveBand(MazeStreamState& a_state, long long a_band)
+{
+  long long firstRow = a_band * a_state.bandRows;
+  int rowCount = min(a_state.bandRows, a_state.source.rows - firstRow);
+  int cols = a_state.source.cols;
+
+  MazeMap band;
+  vector<Position> dragons;
+  if( !(loadBand(a_state.source, firstRow, rowCount, band, dragons)) )
+    return -1;
+
+  // The first band with an entrance holds the first one of all
+  if( !(a_state.foundEntrance) && band.hasEntrance )
+    {
+      a_state.foundEntrance = true;
+      a_state.entranceRow = firstRow + band.entrancePos.x;
+      a_state.entranceCol = band.entrancePos.y;
+    }
+
+  /** SEEDS **/
+
+  vector< pair<long long, int> > seeds;
+
+  if( a_state.foundEntrance && (a_state.entranceRow >= firstRow) &&
+      (a_state.entranceRow < firstRow + rowCount) )
+    seeds.push_back(make_pair(0LL, mazeMapIndex(band, a_state.entranceRow -
+						 firstRow,
+						 a_state.entranceCol)));
+
+  for(int col = 0; col < cols; col++)
+    {
+      if( (a_band > 0) &&
+	  (a_state.bottomDist[a_band - 1][col] != STREAM_UNREACHED) &&
+	  mazeMapOpenTile(band, 0, col) )
+	seeds.push_back(make_pair(a_state.bottomDist[a_band - 1][col] + 1,
+				  mazeMapIndex(band, 0, col)));
+
+      if( (a_band < a_state.bandCount - 1) &&
+	  (a_state.topDist[a_band + 1][col] != STREAM_UNREACHED) &&
+	  mazeMapOpenTile(band, rowCount - 1, col) )
+	seeds.push_back(make_pair(a_state.topDist[a_band + 1][col] + 1,
+				  mazeMapIndex(band, rowCount - 1, col)));
+    }
+
+  sort(seeds.begin(), seeds.end());
+
+  /** BREADTH-FIRST SEARCH **/
+
+  vector<long long>& dist = a_state.dist;
+  dist.assign((long)rowCount * cols, STREAM_UNREACHED);
+
+  Queue<int> frontier(2 * (rowCount + cols));
+  unsigned int nextSeed = 0;
+
+  while( (nextSeed < seeds.size()) || !(frontier.isEmptyQueue()) )
+    {
+      int cell;
+
+      if( (nextSeed < seeds.size()) &&
+	  ( frontier.isEmptyQueue() ||
+	    (seeds[nextSeed].first <= dist[frontier.front()]) ) )
+	{
+	  cell = seeds[nextSeed].second;
+	  if(seeds[nextSeed].first >= dist[cell])
+	    {
+	      nextSeed++;
+	      continue;
+	    }
+	  dist[cell] = seeds[nextSeed].first;
+	  nextSeed++;
+	}
+      else
+	{
+	  cell = frontier.front();
+	  frontier.deleteQueue();
+	}
+
+      int row = cell / cols;
+      int col = cell % cols;
+
+      for(int i = 0; i < 4; i++)
+	{
+	  int nextRow = row + STREAM_DROW[i];
+	  int nextCol = col + STREAM_DCOL[i];
+
+	  if( mazeMapIsOpen(band, nextRow, nextCol) )
+	    {
+	      int next = mazeMapIndex(band, nextRow, nextCol);
+	      if(dist[cell] + 1 < dist[next])
+		{
+		  dist[next] = dist[cell] + 1;
+		  frontier.addQueue(next);
+		}
+	    }
+	}
+    }
+
+  /** RESULTS **/
+
+  a_state.bandDragon[a_band] = STREAM_UNREACHED;
+  for(unsigned int i = 0; i < dragons.size(); i++)
+    {
+      a_state.bandDragon[a_band] =
+	min(a_state.bandDragon[a_band],
+	    dist[mazeMapIndex(band, dragons[i].x, dragons[i].y)]);
+    }
+
+  vector<long long>::iterator top = dist.begin();
+  vector<long long>::iterator bottom = dist.begin() + (long)(rowCount - 1) *
+    cols;
+
+  bool changed =
+    !(equal(top, top + cols, a_state.topDist[a_band].begin())) ||
+    !(equal(bottom, bottom + cols, a_state.bottomDist[a_band].begin()));
+
+  copy(top, top + cols, a_state.topDist[a_band].begin());
+  copy(bottom, bottom + cols, a_state.bottomDist[a_band].begin());
+
+  releaseBand(a_state.source, firstRow, band);
+
+  return changed ? 1 : 0;
+}
+
+
+//-----------------------------------------------------------------------------
+// Function definitions
+//-----------------------------------------------------------------------------
+
+/*
+ * Purpose : Finds whether a dragon can be reached from the entrance, a band
+ *         : of rows at a time, and if asked the length of a shortest path.
+ *         : The distances along the band edges only ever go down, so once
+ *         : a sweep changes none of them every band agrees with its
+ *         : neighbours and the distances are the true ones.
+ * Arguments -
+ *   string a_inputFileName : Maze file (text or binary format)
+ *   long long a_bandRows : Rows per band (0 to pick from the memory budget)
+ *   int a_maxSweeps : Most sweeps to spend on the path length (0 for none)
+ *   MazeStreamResult& a_result : Receives the outcome
+ * Returns : 0 if the maze was solved, -1 if the file cannot be read or its
+ *         : rows are not all the same length
+ */
+int solveMazeStream(string a_inputFileName, long long a_bandRows,
+		    int a_maxSweeps, MazeStreamResult& a_result)
+{
+  int fd = open(a_inputFileName.c_str(), O_RDONLY);
+  if(fd < 0)
+    return -1;
+
+  struct stat fileStat;
+  if( (fstat(fd, &fileStat) != 0) || (fileStat.st_size == 0) )
+    {
+      close(fd);
+      return -1;
+    }
+
+  size_t length = fileStat.st_size;
+  void* mapping = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+
+  if(mapping == MAP_FAILED)
+    return -1;
+
+  // The bands are read front to back (then back to front)
+  madvise(mapping, length, MADV_SEQUENTIAL);
+
+  /** WORK OUT THE FORMAT AND SIZE **/
+
+  MazeStreamState state;
+  MazeStreamSource& source = state.source;
+  source.file = (const char*)mapping;
+  source.length = length;
+  source.binary = mazeBinaryHeaderValid(source.file, length);
+
+  if(source.binary)
+    {
+      source.header = (const MazeBinaryHeader*)source.file;
+      source.landmarks =
+	(const unsigned int*)(source.file + source.header->landmarkOffset);
+      source.walls = (const unsigned long long*)(source.file +
+						 source.header->bitmapOffset);
+      source.rows = source.header->rows;
+      source.cols = source.header->cols;
+    }
+  else if(readMazeMapLayout(source.file, length, source.layout))
+    {
+      source.rows = source.layout.rows;
+      source.cols = source.layout.cols;
+    }
+  else
+    source.cols = 0;
+
+  if( (source.cols < 1) || (source.cols > INT_MAX) )
+    {
+      munmap(mapping, length);
+      return -1;
+    }
+
+  /** PICK THE BANDS **/
+
+  // Half the budget for the band being solved (the other half is for the
+  // edge distances, if the path length is asked for)
+  long long bandRows = a_bandRows;
+  if(bandRows <= 0)
+    bandRows = STREAM_MEMORY_BUDGET / (2 * STREAM_BYTES_PER_CELL *
+				       source.cols);
+  bandRows = min(bandRows, source.rows);
+  bandRows = min(bandRows, (long long)INT_MAX / source.cols);
+  bandRows = max(bandRows, 1LL);
+
+  state.bandRows = bandRows;
+  state.bandCount = (source.rows + bandRows - 1) / bandRows;
+  state.foundEntrance = false;
+
+  a_result.length = -1;
+  a_result.lengthExact = false;
+  a_result.edgesTooBig = false;
+  a_result.sweeps = 0;
+
+  /** ONE PASS FOR REACHABILITY **/
+
+  bool reachable = false;
+  bool valid = (findReachable(state, reachable) == 0);
+
+  /** SWEEP DOWN AND UP FOR THE LENGTH, UNTIL NOTHING CHANGES **/
+
+  if( valid && reachable && (a_maxSweeps > 0) )
+    {
+      if(state.bandCount > STREAM_MEMORY_BUDGET /
+	 (2 * STREAM_BYTES_PER_EDGE * source.cols))
+	a_result.edgesTooBig = true;
+      else
+	{
+	  state.topDist.assign(state.bandCount,
+			       vector<long long>(source.cols,
+						 STREAM_UNREACHED));
+	  state.bottomDist.assign(state.bandCount,
+				  vector<long long>(source.cols,
+						    STREAM_UNREACHED));
+	  state.bandDragon.assign(state.bandCount, STREAM_UNREACHED);
+
+	  bool changed = true;
+	  bool down = true;
+	  int sweeps = 0;
+
+	  while( changed && valid && (sweeps < a_maxSweeps) )
+	    {
+	      changed = false;
+	      sweeps++;
+
+	      // The band a sweep turns round at was just solved, so only
+	      // the first sweep solves it first
+	      for(long long i = (sweeps == 1) ? 0 : 1;
+		  valid && (i < state.bandCount); i++)
+		{
+		  int solved = solveBand(state, down ? i :
+					 state.bandCount - 1 - i);
+		  if(solved < 0)
+		    valid = false;
+		  else if(solved > 0)
+		    changed = true;
+		}
+
+	      down = !down;
+
+	      // With one band, one sweep says it all
+	      if(state.bandCount == 1)
+		changed = false;
+	    }
+
+	  // Every distance found is the length of some path, so one found
+	  // before the sweeps settled is at least an upper bound
+	  long long shortest = *min_element(state.bandDragon.begin(),
+					    state.bandDragon.end());
+	  if(shortest != STREAM_UNREACHED)
+	    a_result.length = shortest;
+	  a_result.lengthExact = !changed;
+	  a_result.sweeps = sweeps;
+	}
+    }
+
+  munmap(mapping, length);
+
+  if( !valid )
+    return -1;
+
+  a_result.foundEntrance = state.foundEntrance;
+  a_result.entranceRow = state.entranceRow;
+  a_result.entranceCol = state.entranceCol;
+  a_result.foundDragon = reachable;
+  a_result.bandRows = state.bandRows;
+  a_result.bandCount = state.bandCount;
+
+  return 0;
+}
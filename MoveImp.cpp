@@ -63,10 +63,9 @@ Move::Move(char initID, int initPosX, int initPosY, Move* initPrevious,
  */
 Move::~Move()
 {
-  // Take care when deleting moves!  Other moves might point to
-  // this memory space as well!  They'll point to a "junk" space
-  // if this is deleted!
-  delete this->previous;
+  // Moves do not own the previous Move!  Several moves can point to
+  // the same previous move, and all of them are handed back together
+  // by the Pool they were allocated from.
 }
 
 
@@ -0,0 +1,134 @@
+/* ------------------------------------------------------------------------- *
+ *
+ * Filename : PackedPath.h
+ * Version  : 1.0
+ *
+ * Purpose  : Stores a path through a two-dimensional maze compactly: the
+ *          : start position once, then two bits per move (E, N, W, S).
+ *          : A 10 million move path takes 2.5 MB.
+ *
+ * ------------------------------------------------------------------------- */
+
+#ifndef H_packedPath
+#define H_packedPath
+
+#include "Move.h"
+
+
+//-----------------------------------------------------------------------------
+// Class declaration
+//-----------------------------------------------------------------------------
+
+class PackedPath
+{
+ public:
+
+  /** Constructors **/
+
+  PackedPath();
+    /* Purpose : To create an empty PackedPath starting at (0, 0)
+     * Postconditions : A PackedPath object will exist
+     */
+
+  PackedPath(const PackedPath& otherPath);
+    /* Purpose : To create a copy of a PackedPath object
+     * Arguments -
+     *   const PackedPath& otherPath : PackedPath to copy
+     * Postconditions : A copy of a PackedPath object will exist
+     */
+
+
+  /** Destructors **/
+
+  ~PackedPath();
+    /* Purpose : To destroy the PackedPath
+     * Postconditions : The packed moves are deallocated
+     */
+
+
+  /** Overloaded operators **/
+
+  const PackedPath& operator=(const PackedPath& otherPath);
+    /* Purpose : Overloads assignment operator
+     * Returns reference to new PackedPath object that will be used in
+     * assignment
+     */
+
+
+  /** Accessors/mutators **/
+
+  Position getStart();
+    /* Purpose : Gets the position the path starts from
+     * Returns : Start position
+     */
+
+  long getLength();
+    /* Purpose : Gets the number of moves on the path
+     * Returns : Number of moves
+     */
+
+  char getMove(long index);
+    /* Purpose : Gets a move
+     * Arguments -
+     *   long index : Index of the move (0 is the first move)
+     * Returns : Move ID (E, N, W, S)
+     */
+
+  void setStart(int newPosX, int newPosY);
+    /* Purpose : Sets the position the path starts from
+     * Arguments -
+     *   int newPosX : x-coordinate (row)
+     *   int newPosY : y-coordinate (column)
+     */
+
+  void setMove(long index, char newID);
+    /* Purpose : Replaces a move
+     * Arguments -
+     *   long index : Index of the move (must be less than the length)
+     *   char newID : Move ID (E, N, W, S)
+     */
+
+  void addMove(char newID);
+    /* Purpose : Appends a move to the end of the path
+     * Arguments -
+     *   char newID : Move ID (E, N, W, S)
+     */
+
+  void resize(long newLength);
+    /* Purpose : Sets the number of moves, so they can be filled in with
+     *         : setMove() in any order
+     * Arguments -
+     *   long newLength : New number of moves
+     */
+
+  void clear();
+    /* Purpose : Removes every move (the start is kept)
+     */
+
+  static Position step(Position pos, char moveID);
+    /* Purpose : Applies one move to a position
+     * Arguments -
+     *   Position pos : Position before the move
+     *   char moveID : Move ID (E, N, W, S)
+     * Returns : Position after the move
+     */
+
+ private:
+
+  void reserve(long newCapacity);
+    /* Purpose : Makes room for newCapacity moves */
+
+  /** Position the path starts from **/
+  Position start;
+
+  /** Moves, four to a byte (two bits each, first move in the low bits) **/
+  unsigned char* moves;
+
+  /** Number of moves on the path **/
+  long length;
+
+  /** Number of moves the byte array has room for **/
+  long capacity;
+};
+
+#endif
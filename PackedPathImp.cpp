@@ -0,0 +1,238 @@
+#include <string.h>
+
+#include "PackedPath.h"
+
+//-----------------------------------------------------------------------------
+// Globals
+//-----------------------------------------------------------------------------
+
+/** Move IDs by their two-bit code **/
+static const char MOVE_IDS[4] = { 'E', 'N', 'W', 'S' };
+
+/*
+ * Purpose : Converts a Move ID to its two-bit code
+ * Arguments -
+ *   char moveID : Move ID (E, N, W, S)
+ * Returns : 0 (E), 1 (N), 2 (W) or 3 (S)
+ */
+static unsigned char moveCode(char moveID)
+{
+  if(moveID == 'E')
+    return 0;
+  else if(moveID == 'N')
+    return 1;
+  else if(moveID == 'W')
+    return 2;
+  else
+    return 3;
+}
+
+
+//-----------------------------------------------------------------------------
+// Class constructors
+//-----------------------------------------------------------------------------
+
+/*
+ * Purpose : To create an empty PackedPath starting at (0, 0)
+ * Postconditions : A PackedPath object will exist
+ */
+PackedPath::PackedPath()
+{
+  this->start.x = 0;
+  this->start.y = 0;
+  this->moves = NULL;
+  this->length = 0;
+  this->capacity = 0;
+}
+
+/*
+ * Purpose : To create a copy of a PackedPath object
+ * Arguments -
+ *   const PackedPath& otherPath : PackedPath to copy
+ * Postconditions : A copy of a PackedPath object will exist
+ */
+PackedPath::PackedPath(const PackedPath& otherPath)
+{
+  this->moves = NULL;
+  this->length = 0;
+  this->capacity = 0;
+
+  *this = otherPath;
+}
+
+
+//-----------------------------------------------------------------------------
+// Class destructors
+//-----------------------------------------------------------------------------
+
+/*
+ * Purpose : To destroy the PackedPath
+ * Postconditions : The packed moves are deallocated
+ */
+PackedPath::~PackedPath()
+{
+  delete [] this->moves;
+}
+
+
+//-----------------------------------------------------------------------------
+// Overloaded operators
+//-----------------------------------------------------------------------------
+
+/*
+ * Purpose : Overloads assignment operator
+ * Returns reference to new PackedPath object that will be used in assignment
+ */
+const PackedPath& PackedPath::operator=(const PackedPath& otherPath)
+{
+  if( this != &otherPath )
+    {
+      this->start = otherPath.start;
+      this->length = 0;
+      this->reserve(otherPath.length);
+
+      if(otherPath.length > 0)
+	memcpy(this->moves, otherPath.moves, (otherPath.length + 3) / 4);
+
+      this->length = otherPath.length;
+    }
+
+  return *this;
+}
+
+
+//-----------------------------------------------------------------------------
+// Accessors/mutators
+//-----------------------------------------------------------------------------
+
+/*
+ * Purpose : Gets the position the path starts from
+ * Returns : Start position
+ */
+Position PackedPath::getStart()
+{
+  return this->start;
+}
+
+/*
+ * Purpose : Gets the number of moves on the path
+ * Returns : Number of moves
+ */
+long PackedPath::getLength()
+{
+  return this->length;
+}
+
+/*
+ * Purpose : Gets a move
+ * Arguments -
+ *   long index : Index of the move (0 is the first move)
+ * Returns : Move ID (E, N, W, S)
+ */
+char PackedPath::getMove(long index)
+{
+  return MOVE_IDS[(this->moves[index >> 2] >> ((index & 3) * 2)) & 3];
+}
+
+/*
+ * Purpose : Sets the position the path starts from
+ * Arguments -
+ *   int newPosX : x-coordinate (row)
+ *   int newPosY : y-coordinate (column)
+ */
+void PackedPath::setStart(int newPosX, int newPosY)
+{
+  this->start.x = newPosX;
+  this->start.y = newPosY;
+}
+
+/*
+ * Purpose : Replaces a move
+ * Arguments -
+ *   long index : Index of the move (must be less than the length)
+ *   char newID : Move ID (E, N, W, S)
+ */
+void PackedPath::setMove(long index, char newID)
+{
+  int shift = (index & 3) * 2;
+  unsigned char& packed = this->moves[index >> 2];
+
+  packed = (packed & ~(3 << shift)) | (moveCode(newID) << shift);
+}
+
+/*
+ * Purpose : Appends a move to the end of the path
+ * Arguments -
+ *   char newID : Move ID (E, N, W, S)
+ */
+void PackedPath::addMove(char newID)
+{
+  if(this->length == this->capacity)
+    this->reserve( (this->capacity == 0) ? 64 : 2 * this->capacity );
+
+  this->length++;
+  this->setMove(this->length - 1, newID);
+}
+
+/*
+ * Purpose : Sets the number of moves, so they can be filled in with
+ *         : setMove() in any order
+ * Arguments -
+ *   long newLength : New number of moves
+ */
+void PackedPath::resize(long newLength)
+{
+  this->reserve(newLength);
+  this->length = newLength;
+}
+
+/*
+ * Purpose : Removes every move (the start is kept)
+ */
+void PackedPath::clear()
+{
+  this->length = 0;
+}
+
+/*
+ * Purpose : Applies one move to a position
+ * Arguments -
+ *   Position pos : Position before the move
+ *   char moveID : Move ID (E, N, W, S)
+ * Returns : Position after the move
+ */
+Position PackedPath::step(Position pos, char moveID)
+{
+  if(moveID == 'E')
+    pos.y++;
+  else if(moveID == 'N')
+    pos.x--;
+  else if(moveID == 'W')
+    pos.y--;
+  else if(moveID == 'S')
+    pos.x++;
+
+  return pos;
+}
+
+/*
+ * Purpose : Makes room for newCapacity moves
+ * Arguments -
+ *   long newCapacity : Number of moves to make room for
+ */
+void PackedPath::reserve(long newCapacity)
+{
+  if(newCapacity <= this->capacity)
+    return;
+
+  // Round up to whole bytes
+  newCapacity = (newCapacity + 3) & ~3L;
+
+  unsigned char* newMoves = new unsigned char[newCapacity / 4]();
+  if(this->length > 0)
+    memcpy(newMoves, this->moves, (this->length + 3) / 4);
+
+  delete [] this->moves;
+  this->moves = newMoves;
+  this->capacity = newCapacity;
+}
@@ -0,0 +1,74 @@
+/* ------------------------------------------------------------------------- *
+ *
+ * Filename : Pool.h
+ * Version  : 1.0
+ *
+ * Purpose  : Implements a pool (arena) allocator.  Memory is carved out of
+ *          : large blocks one slot at a time, released slots are reused
+ *          : through a free list, and every block is handed back in one
+ *          : shot when the pool is released (or destroyed).
+ *
+ * ------------------------------------------------------------------------- */
+
+#ifndef H_pool
+#define H_pool
+
+#include <iostream>
+#include <cassert>
+#include <new>
+
+using namespace std;
+
+
+//-----------------------------------------------------------------------------
+// Class template declaration
+//-----------------------------------------------------------------------------
+
+template<class Type>
+class Pool
+{
+ public:
+  Type* allocate();
+    // Function to get storage for one Type.  The storage is not
+    // constructed; use placement new:  new (pool.allocate()) Type(...)
+    // Postcondition: Returns storage from the free list if any,
+    //                otherwise the next slot of the current block.
+  void release(Type* item);
+    // Function to destroy an item and put its slot on the free list.
+    // Precondition: item came from this pool's allocate().
+  void releaseAll();
+    // Function to hand every block back at once.  Destructors of the
+    // items still allocated are NOT run, so only use this for items
+    // that do not own other resources.
+    // Postcondition: The pool is empty; pointers it gave out are invalid.
+  long allocatedCount();
+    // Function to return the number of items currently allocated.
+  Pool(int initBlockSize = 1024);
+    // Constructor
+    // Postcondition: An empty pool that grows initBlockSize slots at a
+    //                time exists.
+  ~Pool();
+    // Destructor
+    // Postcondition: Same as releaseAll().
+
+ private:
+  union Slot
+  {
+    Slot* next; // link when the slot is free (or the block link)
+    alignas(Type) unsigned char storage[sizeof(Type)];
+  };
+
+  Slot* blockList; // most recent block; its slot 0 links to the previous
+  Slot* freeList;  // released slots
+  int blockSize;   // number of usable slots per block
+  int blockUsed;   // slots handed out from the most recent block
+  long allocated;  // items currently allocated
+
+  Pool(const Pool<Type>&);
+  const Pool<Type>& operator=(const Pool<Type>&);
+    // Not copyable
+};
+
+#include "PoolImp.cpp"
+
+#endif
@@ -0,0 +1,122 @@
+/* ------------------------------------------------------------------------- *
+ *
+ * Filename : PoolImp.cpp
+ * Version  : 1.0
+ *
+ * Purpose  : Implementation of the Pool template class
+ *
+ * ------------------------------------------------------------------------- */
+
+
+//-----------------------------------------------------------------------------
+// Class constructors
+//-----------------------------------------------------------------------------
+
+// Constructor
+// Postcondition: An empty pool that grows initBlockSize slots at a
+//                time exists.
+template<class Type>
+Pool<Type>::Pool(int initBlockSize)
+{
+  if(initBlockSize < 1)
+    initBlockSize = 1;
+
+  blockList = NULL;
+  freeList = NULL;
+  blockSize = initBlockSize;
+  blockUsed = initBlockSize; // forces a block on the first allocate()
+  allocated = 0;
+}
+
+
+//-----------------------------------------------------------------------------
+// Class destructors
+//-----------------------------------------------------------------------------
+
+// Destructor
+// Postcondition: Same as releaseAll().
+template<class Type>
+Pool<Type>::~Pool()
+{
+  releaseAll();
+}
+
+
+//-----------------------------------------------------------------------------
+// "Work" functions (Non-accessor/mutators)
+//-----------------------------------------------------------------------------
+
+// Function to get storage for one Type.
+// Postcondition: Returns storage from the free list if any,
+//                otherwise the next slot of the current block.
+template<class Type>
+Type* Pool<Type>::allocate()
+{
+  Slot* slot;
+
+  if(freeList != NULL)
+    {
+      slot = freeList;
+      freeList = freeList->next;
+    }
+  else
+    {
+      if(blockUsed == blockSize)
+	{
+	  // Slot 0 of each block links to the previous block
+	  Slot* newBlock = new Slot[blockSize + 1];
+	  assert(newBlock != NULL);
+
+	  newBlock[0].next = blockList;
+	  blockList = newBlock;
+	  blockUsed = 0;
+	}
+
+      blockUsed++;
+      slot = &blockList[blockUsed];
+    }
+
+  allocated++;
+
+  return reinterpret_cast<Type*>(slot->storage);
+} // end allocate
+
+// Function to destroy an item and put its slot on the free list.
+// Precondition: item came from this pool's allocate().
+template<class Type>
+void Pool<Type>::release(Type* item)
+{
+  if(item == NULL)
+    return;
+
+  item->~Type();
+
+  Slot* slot = reinterpret_cast<Slot*>(item);
+  slot->next = freeList;
+  freeList = slot;
+  allocated--;
+} // end release
+
+// Function to hand every block back at once.
+// Postcondition: The pool is empty; pointers it gave out are invalid.
+template<class Type>
+void Pool<Type>::releaseAll()
+{
+  while(blockList != NULL)
+    {
+      Slot* prevBlock = blockList[0].next;
+      delete [] blockList;
+      blockList = prevBlock;
+    }
+
+  freeList = NULL;
+  blockUsed = blockSize;
+  allocated = 0;
+} // end releaseAll
+
+// Function to return the number of items currently allocated.
+template<class Type>
+long Pool<Type>::allocatedCount()
+{
+  return allocated;
+}
@@ -0,0 +1,76 @@
+/* ------------------------------------------------------------------------- *
+ *
+ * Filename : PriorityQueue.h
+ * Version  : 1.0
+ *
+ * Purpose  : Implements a min-priority queue as an array-backed 4-ary heap.
+ *          : A node's four children sit next to each other in the array,
+ *          : so sifting down touches one cache line per level.  Elements
+ *          : are ordered with operator<.
+ *
+ * ------------------------------------------------------------------------- */
+
+#ifndef H_priorityQueue
+#define H_priorityQueue
+
+#include <iostream>
+#include <cassert>
+
+using namespace std;
+
+
+//-----------------------------------------------------------------------------
+// Class template declaration
+//-----------------------------------------------------------------------------
+
+template<class Type>
+class PriorityQueue
+{
+ public:
+  void initializeQueue();
+    // Function to initialize the queue to an empty state.
+    // Postcondition: count = 0.
+  bool isEmptyQueue();
+    // Function to determine whether the queue is empty.
+    // Postcondition: Returns true if the queue is empty;
+    //                otherwise, returns false.
+  void addQueue(const Type& newElement);
+    // Function to add newElement to the queue.
+    // Precondition: The queue exists.
+    // Postcondition: The queue is changed and newElement
+    //                is placed according to its priority.
+  Type front();
+    // Function to return the smallest element of the queue.
+    // Precondition: The queue exists and is not empty.
+    // Postcondition: If the queue is empty, the program
+    //                terminates; otherwise, the smallest element
+    //                of the queue is returned.
+  void deleteQueue();
+    // Function to remove the smallest element of the queue.
+    // Precondition: The queue exists and is not empty.
+    // Postcondition: The queue is changed and the smallest element
+    //                is removed from the queue.
+  int size();
+    // Function to return the number of elements in the queue.
+  PriorityQueue(int initialCapacity = 64);
+    // Constructor
+    // Postcondition: An empty queue with room for initialCapacity
+    //                elements exists.
+  ~PriorityQueue();
+    // Destructor
+    // Postcondition: The heap array is deallocated.
+
+ private:
+  Type* list;   // heap array; children of i are 4i+1 .. 4i+4
+  int capacity; // size of the heap array
+  int count;    // number of elements in the queue
+  void grow();
+    // Function to double the size of the heap array.
+  PriorityQueue(const PriorityQueue<Type>&);
+  const PriorityQueue<Type>& operator=(const PriorityQueue<Type>&);
+    // Not copyable
+};
+
+#include "PriorityQueueImp.cpp"
+
+#endif
@@ -0,0 +1,170 @@
+/* ------------------------------------------------------------------------- *
+ *
+ * Filename : PriorityQueueImp.cpp
+ * Version  : 1.0
+ *
+ * Purpose  : Implementation of the PriorityQueue template class
+ *
+ * ------------------------------------------------------------------------- */
+
+
+//-----------------------------------------------------------------------------
+// Class constructors
+//-----------------------------------------------------------------------------
+
+// Constructor
+// Postcondition: An empty queue with room for initialCapacity
+//                elements exists.
+template<class Type>
+PriorityQueue<Type>::PriorityQueue(int initialCapacity)
+{
+  if(initialCapacity < 1)
+    initialCapacity = 1;
+
+  capacity = initialCapacity;
+  list = new Type[capacity];
+  count = 0;
+}
+
+
+//-----------------------------------------------------------------------------
+// Class destructors
+//-----------------------------------------------------------------------------
+
+// Destructor
+// Postcondition: The heap array is deallocated.
+template<class Type>
+PriorityQueue<Type>::~PriorityQueue()
+{
+  delete [] list;
+}
+
+
+//-----------------------------------------------------------------------------
+// "Work" functions (Non-accessor/mutators)
+//-----------------------------------------------------------------------------
+
+// Function to initialize the queue to an empty state.
+// Postcondition: count = 0.
+template<class Type>
+void PriorityQueue<Type>::initializeQueue()
+{
+  count = 0;
+}
+
+// Function to determine whether the queue is empty.
+// Postcondition: Returns true if the queue is empty;
+//                otherwise, returns false.
+template<class Type>
+bool PriorityQueue<Type>::isEmptyQueue()
+{
+  return(count == 0);
+}
+
+// Function to add newElement to the queue.
+// Precondition: The queue exists.
+// Postcondition: The queue is changed and newElement
+//                is placed according to its priority.
+template<class Type>
+void PriorityQueue<Type>::addQueue(const Type& newElement)
+{
+  if(count == capacity)
+    grow();
+
+  // Sift up: move parents down until newElement's spot is found
+  int hole = count;
+  while(hole > 0)
+    {
+      int parent = (hole - 1) / 4;
+      if( !(newElement < list[parent]) )
+	break;
+
+      list[hole] = list[parent];
+      hole = parent;
+    }
+
+  list[hole] = newElement;
+  count++;
+} // end addQueue
+
+// Function to return the smallest element of the queue.
+// Precondition: The queue exists and is not empty.
+// Postcondition: If the queue is empty, the program
+//                terminates; otherwise, the smallest element
+//                of the queue is returned.
+template<class Type>
+Type PriorityQueue<Type>::front()
+{
+  assert(count != 0); // if the queue is empty,
+                      // terminate the program
+  return list[0];
+} // end front
+
+// Function to remove the smallest element of the queue.
+// Precondition: The queue exists and is not empty.
+// Postcondition: The queue is changed and the smallest element
+//                is removed from the queue.
+template<class Type>
+void PriorityQueue<Type>::deleteQueue()
+{
+  if(count == 0)
+    {
+      cerr << "Cannot remove from an empty queue." << endl;
+      return;
+    }
+
+  count--;
+  if(count == 0)
+    return;
+
+  // Sift down: the last element fills the hole left at the root
+  Type last = list[count];
+  int hole = 0;
+
+  while(true)
+    {
+      int firstChild = 4 * hole + 1;
+      if(firstChild >= count)
+	break;
+
+      // Find the smallest of (up to) four children
+      int smallest = firstChild;
+      int lastChild = firstChild + 4;
+      if(lastChild > count)
+	lastChild = count;
+      for(int child = firstChild + 1; child < lastChild; child++)
+	{
+	  if(list[child] < list[smallest])
+	    smallest = child;
+	}
+
+      if( !(list[smallest] < last) )
+	break;
+
+      list[hole] = list[smallest];
+      hole = smallest;
+    }
+
+  list[hole] = last;
+} // end deleteQueue
+
+// Function to return the number of elements in the queue.
+template<class Type>
+int PriorityQueue<Type>::size()
+{
+  return count;
+}
+
+// Function to double the size of the heap array.
+template<class Type>
+void PriorityQueue<Type>::grow()
+{
+  Type* newList = new Type[2 * capacity];
+
+  for(int i = 0; i < count; i++)
+    newList[i] = list[i];
+
+  delete [] list;
+  list = newList;
+  capacity = 2 * capacity;
+} // end grow
@@ -0,0 +1,77 @@
+/* ------------------------------------------------------------------------- *
+ *
+ * Filename : Queue.h
+ * Version  : 1.0
+ *
+ * Purpose  : Implements a FIFO queue as a ring buffer (an array that wraps
+ *          : around).  The buffer doubles in size whenever it fills up.
+ *
+ * ------------------------------------------------------------------------- */
+
+#ifndef H_queue
+#define H_queue
+
+#include <iostream>
+#include <cassert>
+
+using namespace std;
+
+
+//-----------------------------------------------------------------------------
+// Class template declaration
+//-----------------------------------------------------------------------------
+
+template<class Type>
+class Queue
+{
+ public:
+  void initializeQueue();
+    // Function to initialize the queue to an empty state.
+    // Postcondition: count = 0; queueFront = 0.
+  bool isEmptyQueue();
+    // Function to determine whether the queue is empty.
+    // Postcondition: Returns true if the queue is empty;
+    //                otherwise, returns false.
+  void addQueue(const Type& newElement);
+    // Function to add newElement to the back of the queue.
+    // Precondition: The queue exists.
+    // Postcondition: The queue is changed and newElement
+    //                is added to the back of the queue.
+  Type front();
+    // Function to return the first element of the queue.
+    // Precondition: The queue exists and is not empty.
+    // Postcondition: If the queue is empty, the program
+    //                terminates; otherwise, the first element
+    //                of the queue is returned.
+  void deleteQueue();
+    // Function to remove the first element of the queue.
+    // Precondition: The queue exists and is not empty.
+    // Postcondition: The queue is changed and the first element
+    //                is removed from the queue.
+  int size();
+    // Function to return the number of elements in the queue.
+  Queue(int initialCapacity = 64);
+    // Constructor
+    // Postcondition: An empty queue with room for initialCapacity
+    //                elements exists.
+  ~Queue();
+    // Destructor
+    // Postcondition: The ring buffer is deallocated.
+
+ private:
+  Type* list;     // ring buffer holding the elements
+  int capacity;   // size of the ring buffer
+  int count;      // number of elements in the queue
+  int queueFront; // index of the first element
+  void grow();
+    // Function to double the size of the ring buffer.
+    // Postcondition: The elements are unwrapped into a buffer twice
+    //                the size, starting at index 0.
+  Queue(const Queue<Type>&);
+  const Queue<Type>& operator=(const Queue<Type>&);
+    // Not copyable
+};
+
+#include "QueueImp.cpp"
+
+#endif
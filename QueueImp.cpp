@@ -0,0 +1,137 @@
+/* ------------------------------------------------------------------------- *
+ *
+ * Filename : QueueImp.cpp
+ * Version  : 1.0
+ *
+ * Purpose  : Implementation of the Queue template class
+ *
+ * ------------------------------------------------------------------------- */
+
+
+//-----------------------------------------------------------------------------
+// Class constructors
+//-----------------------------------------------------------------------------
+
+// Constructor
+// Postcondition: An empty queue with room for initialCapacity
+//                elements exists.
+template<class Type>
+Queue<Type>::Queue(int initialCapacity)
+{
+  if(initialCapacity < 1)
+    initialCapacity = 1;
+
+  capacity = initialCapacity;
+  list = new Type[capacity];
+  count = 0;
+  queueFront = 0;
+}
+
+
+//-----------------------------------------------------------------------------
+// Class destructors
+//-----------------------------------------------------------------------------
+
+// Destructor
+// Postcondition: The ring buffer is deallocated.
+template<class Type>
+Queue<Type>::~Queue()
+{
+  delete [] list;
+}
+
+
+//-----------------------------------------------------------------------------
+// "Work" functions (Non-accessor/mutators)
+//-----------------------------------------------------------------------------
+
+// Function to initialize the queue to an empty state.
+// Postcondition: count = 0; queueFront = 0.
+template<class Type>
+void Queue<Type>::initializeQueue()
+{
+  count = 0;
+  queueFront = 0;
+}
+
+// Function to determine whether the queue is empty.
+// Postcondition: Returns true if the queue is empty;
+//                otherwise, returns false.
+template<class Type>
+bool Queue<Type>::isEmptyQueue()
+{
+  return(count == 0);
+}
+
+// Function to add newElement to the back of the queue.
+// Precondition: The queue exists.
+// Postcondition: The queue is changed and newElement
+//                is added to the back of the queue.
+template<class Type>
+void Queue<Type>::addQueue(const Type& newElement)
+{
+  if(count == capacity)
+    grow();
+
+  int queueRear = queueFront + count; // one past the last element
+  if(queueRear >= capacity)
+    queueRear -= capacity; // wrap around
+
+  list[queueRear] = newElement;
+  count++;
+} // end addQueue
+
+// Function to return the first element of the queue.
+// Precondition: The queue exists and is not empty.
+// Postcondition: If the queue is empty, the program
+//                terminates; otherwise, the first element
+//                of the queue is returned.
+template<class Type>
+Type Queue<Type>::front()
+{
+  assert(count != 0); // if the queue is empty,
+                      // terminate the program
+  return list[queueFront];
+} // end front
+
+// Function to remove the first element of the queue.
+// Precondition: The queue exists and is not empty.
+// Postcondition: The queue is changed and the first element
+//                is removed from the queue.
+template<class Type>
+void Queue<Type>::deleteQueue()
+{
+  if(count != 0)
+    {
+      queueFront++;
+      if(queueFront == capacity)
+	queueFront = 0; // wrap around
+      count--;
+    }
+  else
+    cerr << "Cannot remove from an empty queue." << endl;
+} // end deleteQueue
+
+// Function to return the number of elements in the queue.
+template<class Type>
+int Queue<Type>::size()
+{
+  return count;
+}
+
+// Function to double the size of the ring buffer.
+// Postcondition: The elements are unwrapped into a buffer twice
+//                the size, starting at index 0.
+template<class Type>
+void Queue<Type>::grow()
+{
+  Type* newList = new Type[2 * capacity];
+
+  for(int i = 0; i < count; i++)
+    newList[i] = list[(queueFront + i) % capacity];
+
+  delete [] list;
+  list = newList;
+  capacity = 2 * capacity;
+  queueFront = 0;
+} // end grow
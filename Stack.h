@@ -7,7 +7,8 @@
  * Date     : March 3, 2007
  *
  * Purpose  : Implements a FILO stack (based on the Stack implementation in
- *          : 'Data Structures Using C++' by Merlin (used in class).
+ *          : 'Data Structures Using C++' by Merlin (used in class).  The
+ *          : elements are kept in one array that doubles when it fills.
  *
  * ------------------------------------------------------------------------- */
 
@@ -20,19 +21,6 @@
 using namespace std;
 
 
-//-----------------------------------------------------------------------------
-// Support structures
-//-----------------------------------------------------------------------------
-
-// Basic node implementation
-template<class Type>
-struct Node
-{
-  Type info;
-  Node<Type> *link;
-};
-
-
 //-----------------------------------------------------------------------------
 // Class template declaration
 //-----------------------------------------------------------------------------
@@ -46,7 +34,7 @@ class Stack
   void initializeStack();
     // Function to initialize the stack to an empty state.
     // Postcondition: The stack elements are removed;
-    //                stackTop = NULL.
+    //                stackTop = 0.
   bool isEmptyStack();
     // Function to determine whether the stack is empty.
     // Postcondition: Retruns true if the stack is empty;
@@ -57,7 +45,7 @@ class Stack
   void destroyStack();
     // Function to remove all the elements of the stack,
     // leaving the stack in an empty state.
-    // Postcondition: stackTop = NULL
+    // Postcondition: stackTop = 0
   void push(const Type& newItem);
     // Function to add newItem to the stack.
     // Precondition: The stack exists and is not full.
@@ -74,9 +62,15 @@ class Stack
     // Precondition: The stack exists and is not empty.
     // Postcondition: The stack is changed and the top element
     //                is removed from the stack.
+  void reserve(int newCapacity);
+    // Function to make room for newCapacity elements up front,
+    // so pushes up to that depth never reallocate.
+    // Postcondition: maxStackSize >= newCapacity.
+  int size();
+    // Function to return the number of elements in the stack.
   Stack();
     // Default constructor
-    // Postcondition: stackTop = NULL
+    // Postcondition: stackTop = 0
   Stack(const Stack<Type>& otherStack);
     // Copy constructor
   ~Stack();
@@ -84,7 +78,9 @@ class Stack
     // Postcondition: All the elements of the stack are removed
 
  private:
-  Node<Type> *stackTop; // pointer to the stack
+  Type *list;       // array holding the stack elements
+  int stackTop;     // number of elements (index of the next push)
+  int maxStackSize; // size of list; doubles when it fills up
   void copyStack(const Stack<Type>& otherStack);
     // Function to make a copy of otherStack.
     // Postcondition: A copy of otherStack is created and
@@ -16,20 +16,24 @@
 //-----------------------------------------------------------------------------
 
 // Default constructor
-// Postcondition: stackTop = NULL
+// Postcondition: stackTop = 0
 template<class Type> // default constructor
 Stack<Type>::Stack()
 {
-  stackTop = NULL;
+  list = NULL;
+  stackTop = 0;
+  maxStackSize = 0;
 }
 
 // Copy constructor
 template<class Type>
 Stack<Type>::Stack(const Stack<Type>& otherStack)
 {
+  list = NULL;
+  stackTop = 0;
+  maxStackSize = 0;
+
   this->copyStack( otherStack );
-  
-  return *this;
 }
 
 //-----------------------------------------------------------------------------
@@ -41,7 +45,7 @@ Stack<Type>::Stack(const Stack<Type>& otherStack)
 template<class Type> // default destructor
 Stack<Type>::~Stack()
 {
-  destroyStack();
+  delete [] list;
 }
 
 
@@ -64,27 +68,16 @@ const Stack<Type>& Stack<Type>::operator=(const Stack<Type>& otherStack)
 
 // Function to remove all the elements of the stack,
 // leaving the stack in an empty state.
-// Postcondition: stackTop = NULL
+// Postcondition: stackTop = 0
 template<class Type>
 void Stack<Type>::destroyStack()
 {
-  Node<Type> *temp; // pointer to delete the node
-
-  while(stackTop != NULL) // while there are elements
-                          // in the stack
-    {
-      temp = stackTop; // Set temp to point to
-                       // the current node
-      stackTop = stackTop->link; // advance stackTop
-                                 // to the next node
-      delete temp; // deallocate the memory
-                   // occupied by temp
-    }
+  stackTop = 0; // the array is kept for reuse
 } // end destroyStack
 
 // Function to initialize the stack to an empty state.
 // Postcondition: The stack elements are removed;
-//                stackTop = NULL.
+//                stackTop = 0.
 template<class Type>
 void Stack<Type>::initializeStack()
 {
@@ -97,7 +90,7 @@ void Stack<Type>::initializeStack()
 template<class Type>
 bool Stack<Type>::isEmptyStack()
 {
-  return(stackTop == NULL);
+  return(stackTop == 0);
 }
 
 // Function to determine whether the stack is full;
@@ -115,15 +108,11 @@ bool Stack<Type>::isFullStack()
 template<class Type>
 void Stack<Type>::push(const Type& newElement)
 {
-  Node<Type> *newNode; // pointer to create the new node
+  if(stackTop == maxStackSize) // out of room, so double the array
+    reserve( (maxStackSize == 0) ? 16 : 2 * maxStackSize );
 
-  newNode = new Node<Type>; // create the node
-  assert(newNode != NULL);
-
-  newNode->info = newElement; // store newElement in the node
-  newNode->link = stackTop; // insert newNode before stackTop
-  stackTop = newNode; // set stackTop to point to the
-                      // top node
+  list[stackTop] = newElement; // store newElement at the top
+  stackTop++; // advance stackTop to the next free slot
 } // end push
 
 // Function to return the top element of the stack.
@@ -134,9 +123,9 @@ void Stack<Type>::push(const Type& newElement)
 template<class Type>
 Type Stack<Type>::top()
 {
-  assert(stackTop != NULL); // if the stack is empty,
-                            // terminate the program
-  return stackTop->info; // return the top element
+  assert(stackTop != 0); // if the stack is empty,
+                         // terminate the program
+  return list[stackTop - 1]; // return the top element
 } // end top
 
 // Function to remove the stack top element of the stack.
@@ -146,18 +135,39 @@ Type Stack<Type>::top()
 template<class Type>
 void Stack<Type>::pop()
 {
-  Node<Type> *temp; // pointer to deallocate the memory
-
-  if(stackTop != NULL)
-    {
-      temp = stackTop; // set temp to point to the top node
-      stackTop = stackTop->link; // advance stackTop to the next node
-      delete temp; // delete teh top node
-    }
+  if(stackTop != 0)
+    stackTop--; // drop the top element
   else
     cerr << "Cannot remove from an empty stack." << endl;
 } // end pop
 
+// Function to make room for newCapacity elements up front,
+// so pushes up to that depth never reallocate.
+// Postcondition: maxStackSize >= newCapacity.
+template<class Type>
+void Stack<Type>::reserve(int newCapacity)
+{
+  if(newCapacity <= maxStackSize)
+    return;
+
+  Type *newList = new Type[newCapacity];
+  assert(newList != NULL);
+
+  for(int i = 0; i < stackTop; i++)
+    newList[i] = list[i];
+
+  delete [] list;
+  list = newList;
+  maxStackSize = newCapacity;
+} // end reserve
+
+// Function to return the number of elements in the stack.
+template<class Type>
+int Stack<Type>::size()
+{
+  return stackTop;
+}
+
 // Function to make a copy of otherStack.
 // Postcondition: A copy of otherStack is created and
 //                assigned to this stack.
@@ -166,24 +176,13 @@ void Stack<Type>::copyStack(const Stack<Type>& otherStack)
 {
   if( this != &otherStack )
     {
-      Stack<Type> tmpBuffStack;
-      
-      Type* pTypePtr = NULL;
-      if( !(otherStack.isEmptyStack()) )
-	pTypePtr = &otherStack.top();
-
-      // Store stack, backwards!
-      while( pTypePtr != NULL )
-	{
-	  tmpBuffStack.push( otherStack.top() );
-	  pTypePtr = pTypePtr->getPrevious();
-	}
-
-      // Read backwards stack into this stack
-      while( !(tmpBuffStack.isEmptyList()) )
-	{
-	  this->push( tmpBuffStack.top() );
-	  tmpBuffStack.pop();
-	}
+      stackTop = 0;
+      reserve( otherStack.stackTop );
+
+      // Copy the elements bottom to top, so the order is kept
+      for(int i = 0; i < otherStack.stackTop; i++)
+	list[i] = otherStack.list[i];
+
+      stackTop = otherStack.stackTop;
     }
 }
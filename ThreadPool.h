@@ -0,0 +1,124 @@
+/* ------------------------------------------------------------------------- *
+ *
+ * Filename : ThreadPool.h
+ * Version  : 1.0
+ *
+ * Purpose  : Implements a pool of worker threads that run numbered tasks.
+ *          : Each worker starts with its own contiguous block of tasks and
+ *          : takes them from the front; a worker that runs dry steals the
+ *          : back half of another worker's block.
+ *
+ * ------------------------------------------------------------------------- */
+
+#ifndef H_threadPool
+#define H_threadPool
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+using namespace std;
+
+
+//-----------------------------------------------------------------------------
+// "Support" structures (meaning, that they help make code pretty)
+//-----------------------------------------------------------------------------
+
+// Name: ThreadTask
+// Purpose: A task run by the pool.  Receives the task number and the
+//        : context pointer handed to runTasks().
+typedef void (*ThreadTask)(int a_index, void* a_context);
+
+
+//-----------------------------------------------------------------------------
+// Class declaration
+//-----------------------------------------------------------------------------
+
+class ThreadPool
+{
+ public:
+
+  /** Constructors **/
+
+  ThreadPool(int initThreadCount);
+    /* Purpose : To create a pool and start its worker threads
+     * Arguments -
+     *   int initThreadCount : Number of threads to run tasks on, counting
+     *                       : the thread that calls runTasks() (0 means
+     *                       : one per core)
+     * Postconditions : The worker threads will be waiting for tasks
+     */
+
+
+  /** Destructors **/
+
+  ~ThreadPool();
+    /* Purpose : To stop and join the worker threads
+     * Postconditions : No worker threads will be running
+     */
+
+
+  /** Accessors/mutators **/
+
+  int getThreadCount();
+    /* Purpose : Gets the number of threads tasks run on
+     * Returns : Thread count (including the caller of runTasks())
+     */
+
+  void runTasks(int taskCount, ThreadTask task, void* context);
+    /* Purpose : Runs task(i, context) for every i in [0, taskCount) and
+     *         : waits for all of them to finish.  The calling thread runs
+     *         : tasks too.
+     * Arguments -
+     *   int taskCount : Number of tasks
+     *   ThreadTask task : Function to run
+     *   void* context : Passed through to every task
+     */
+
+ private:
+
+  /** A worker's block of tasks, [front, back) **/
+  struct WorkQueue
+  {
+    mutex lock;
+    int front;
+    int back;
+  };
+
+  void workerLoop(int worker);
+    /* Purpose : Body of each background worker thread */
+
+  void drainTasks(int worker);
+    /* Purpose : Runs tasks until no worker has any left */
+
+  bool takeTask(int worker, int& index);
+    /* Purpose : Takes the next task from the worker's own block, or steals
+     *         : from another worker's block when its own is empty
+     * Returns : Whether a task was found
+     */
+
+  /** Number of threads (queues[0] belongs to the caller of runTasks()) **/
+  int threadCount;
+  WorkQueue* queues;
+  thread* workers;
+
+  /** The tasks being run **/
+  ThreadTask currentTask;
+  void* currentContext;
+  atomic<int> remaining;
+
+  /** Coordination between runTasks() and the workers **/
+  mutex poolLock;
+  condition_variable wakeWorkers;
+  condition_variable tasksDone;
+  long generation;
+  int busyWorkers;
+  bool stopping;
+
+  ThreadPool(const ThreadPool&);
+  const ThreadPool& operator=(const ThreadPool&);
+    // Not copyable
+};
+
+#endif
@@ -0,0 +1,236 @@
+#include "ThreadPool.h"
+
+//-----------------------------------------------------------------------------
+// Class constructors
+//-----------------------------------------------------------------------------
+
+/*
+ * Purpose : To create a pool and start its worker threads
+ * Arguments -
+ *   int initThreadCount : Number of threads to run tasks on, counting
+ *                       : the thread that calls runTasks() (0 means
+ *                       : one per core)
+ * Postconditions : The worker threads will be waiting for tasks
+ */
+ThreadPool::ThreadPool(int initThreadCount)
+{
+  if(initThreadCount <= 0)
+    initThreadCount = thread::hardware_concurrency();
+  if(initThreadCount <= 0)
+    initThreadCount = 1;
+
+  this->threadCount = initThreadCount;
+  this->queues = new WorkQueue[initThreadCount];
+  for(int i = 0; i < initThreadCount; i++)
+    {
+      this->queues[i].front = 0;
+      this->queues[i].back = 0;
+    }
+
+  this->currentTask = NULL;
+  this->currentContext = NULL;
+  this->remaining = 0;
+  this->generation = 0;
+  this->busyWorkers = 0;
+  this->stopping = false;
+
+  // Worker 0 is whoever calls runTasks(), so start one thread fewer
+  this->workers = new thread[initThreadCount];
+  for(int i = 1; i < initThreadCount; i++)
+    this->workers[i] = thread(&ThreadPool::workerLoop, this, i);
+}
+
+
+//-----------------------------------------------------------------------------
+// Class destructors
+//-----------------------------------------------------------------------------
+
+/*
+ * Purpose : To stop and join the worker threads
+ * Postconditions : No worker threads will be running
+ */
+ThreadPool::~ThreadPool()
+{
+  {
+    unique_lock<mutex> guard(this->poolLock);
+    this->stopping = true;
+  }
+  this->wakeWorkers.notify_all();
+
+  for(int i = 1; i < this->threadCount; i++)
+    this->workers[i].join();
+
+  delete [] this->workers;
+  delete [] this->queues;
+}
+
+
+//-----------------------------------------------------------------------------
+// Accessors/mutators
+//-----------------------------------------------------------------------------
+
+/*
+ * Purpose : Gets the number of threads tasks run on
+ * Returns : Thread count (including the caller of runTasks())
+ */
+int ThreadPool::getThreadCount()
+{
+  return this->threadCount;
+}
+
+/*
+ * Purpose : Runs task(i, context) for every i in [0, taskCount) and waits
+ *         : for all of them to finish.  The calling thread runs tasks too.
+ * Arguments -
+ *   int taskCount : Number of tasks
+ *   ThreadTask task : Function to run
+ *   void* context : Passed through to every task
+ */
+void ThreadPool::runTasks(int taskCount, ThreadTask task, void* context)
+{
+  if(taskCount <= 0)
+    return;
+
+  {
+    unique_lock<mutex> guard(this->poolLock);
+
+    // A worker that woke too late for the last call may still be looking
+    // for tasks; once it parks, the blocks can be handed out without
+    // taking the queue locks
+    while(this->busyWorkers > 0)
+      this->tasksDone.wait(guard);
+
+    this->currentTask = task;
+    this->currentContext = context;
+    this->remaining = taskCount;
+
+    for(int i = 0; i < this->threadCount; i++)
+      {
+	this->queues[i].front = (int)((long long)taskCount * i /
+				      this->threadCount);
+	this->queues[i].back = (int)((long long)taskCount * (i + 1) /
+				     this->threadCount);
+      }
+
+    this->generation++;
+  }
+  this->wakeWorkers.notify_all();
+
+  drainTasks(0);
+
+  // Wait for the tasks still running on the workers
+  unique_lock<mutex> guard(this->poolLock);
+  while( (this->remaining > 0) || (this->busyWorkers > 0) )
+    this->tasksDone.wait(guard);
+}
+
+
+//-----------------------------------------------------------------------------
+// Helper functions
+//-----------------------------------------------------------------------------
+
+/*
+ * Purpose : Body of each background worker thread
+ * Arguments -
+ *   int worker : Index of the worker (and of its queue)
+ */
+void ThreadPool::workerLoop(int worker)
+{
+  long seenGeneration = 0;
+
+  while(true)
+    {
+      {
+	unique_lock<mutex> guard(this->poolLock);
+	while( !(this->stopping) && (this->generation == seenGeneration) )
+	  this->wakeWorkers.wait(guard);
+
+	if(this->stopping)
+	  return;
+
+	seenGeneration = this->generation;
+	this->busyWorkers++;
+      }
+
+      drainTasks(worker);
+
+      {
+	unique_lock<mutex> guard(this->poolLock);
+	this->busyWorkers--;
+	if( (this->busyWorkers == 0) && (this->remaining == 0) )
+	  this->tasksDone.notify_all();
+      }
+    }
+}
+
+/*
+ * Purpose : Runs tasks until no worker has any left
+ * Arguments -
+ *   int worker : Index of the worker running them
+ */
+void ThreadPool::drainTasks(int worker)
+{
+  int index;
+
+  while( takeTask(worker, index) )
+    {
+      this->currentTask(index, this->currentContext);
+
+      if(--(this->remaining) == 0)
+	{
+	  unique_lock<mutex> guard(this->poolLock);
+	  this->tasksDone.notify_all();
+	}
+    }
+}
+
+/*
+ * Purpose : Takes the next task from the worker's own block, or steals the
+ *         : back half of another worker's block when its own is empty
+ * Arguments -
+ *   int worker : Index of the worker
+ *   int& index : Receives the task number
+ * Returns : Whether a task was found
+ */
+bool ThreadPool::takeTask(int worker, int& index)
+{
+  WorkQueue& own = this->queues[worker];
+
+  {
+    unique_lock<mutex> guard(own.lock);
+    if(own.front < own.back)
+      {
+	index = own.front++;
+	return true;
+      }
+  }
+
+  // Look for a victim, starting with the next worker along
+  for(int i = 1; i < this->threadCount; i++)
+    {
+      WorkQueue& victim = this->queues[(worker + i) % this->threadCount];
+      int stolenFront, stolenBack;
+
+      {
+	unique_lock<mutex> guard(victim.lock);
+	int left = victim.back - victim.front;
+	if(left <= 0)
+	  continue;
+
+	stolenBack = victim.back;
+	stolenFront = victim.back - (left + 1) / 2;
+	victim.back = stolenFront;
+      }
+
+      // Run the first stolen task now and keep the rest
+      index = stolenFront;
+      {
+	unique_lock<mutex> guard(own.lock);
+	own.front = stolenFront + 1;
+	own.back = stolenBack;
+      }
+      return true;
+    }
+
+  return false;
+}